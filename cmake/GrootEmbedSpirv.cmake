@@ -0,0 +1,16 @@
+# Invoked by groot_compile_shaders as `cmake -DINPUT= -DOUTPUT= -DIDENTIFIER= -P`.
+# Writes INPUT as a C++ array of little-endian 32-bit SPIR-V words.
+
+file(READ ${INPUT} contents HEX)
+string(REGEX REPLACE "(..)(..)(..)(..)" "0x\\4\\3\\2\\1, " words "${contents}")
+string(REPEAT "0x[0-9a-f]+, " 8 line)
+string(REGEX REPLACE "(${line})" "\\1\n  " words "${words}")
+string(REPLACE ", \n" ",\n" words "${words}")
+string(REGEX REPLACE "[, \n]+$" "" words "${words}")
+
+file(WRITE ${OUTPUT}
+  "#pragma once\n\n"
+  "namespace groot_shaders {\n\n"
+  "inline constexpr unsigned int ${IDENTIFIER}[] = {\n  ${words}\n};\n\n"
+  "} // namespace groot_shaders\n"
+)
@@ -0,0 +1,95 @@
+# groot_compile_shaders(<target>
+#   SOURCES <file>...
+#   [EMBED]
+#   [OUTPUT_DIRECTORY <dir>]
+#   [INSTALL_DESTINATION <dir>]
+#   [INCLUDE_DIRECTORIES <dir>...]
+#   [DEFINES <name[=value]>...]
+# )
+#
+# Compiles GLSL sources to SPIR-V with glslc when <target> is built. The shader
+# stage is taken from the file extension (.vert, .frag, .tesc, .tese, .comp) or
+# from a `#pragma shader_stage(...)` in the source. Each source produces
+# <OUTPUT_DIRECTORY>/<filename>.spv, loadable with Engine::load_shader_spirv.
+# With EMBED, a header groot_shaders/<filename>.hpp is also generated on the
+# target's include path declaring `groot_shaders::<filename>` as an array of
+# SPIR-V words.
+
+function(groot_compile_shaders target)
+  cmake_parse_arguments(PARSE_ARGV 1 GROOT
+    "EMBED"
+    "OUTPUT_DIRECTORY;INSTALL_DESTINATION"
+    "SOURCES;INCLUDE_DIRECTORIES;DEFINES"
+  )
+
+  if (NOT GROOT_SOURCES)
+    message(FATAL_ERROR "groot_compile_shaders: no SOURCES given for ${target}")
+  endif()
+
+  find_program(GROOT_GLSLC glslc HINTS "$ENV{VULKAN_SDK}/bin" REQUIRED)
+
+  if (NOT GROOT_OUTPUT_DIRECTORY)
+    set(GROOT_OUTPUT_DIRECTORY ${CMAKE_CURRENT_BINARY_DIR}/shaders)
+  endif()
+
+  set(flags --target-env=vulkan1.4 -O)
+  foreach(directory IN LISTS GROOT_INCLUDE_DIRECTORIES)
+    list(APPEND flags -I${directory})
+  endforeach()
+  foreach(define IN LISTS GROOT_DEFINES)
+    list(APPEND flags -D${define})
+  endforeach()
+
+  set(embedScript ${CMAKE_CURRENT_FUNCTION_LIST_DIR}/GrootEmbedSpirv.cmake)
+  set(embedDirectory ${CMAKE_CURRENT_BINARY_DIR}/groot_shaders)
+
+  set(outputs)
+  foreach(source IN LISTS GROOT_SOURCES)
+    cmake_path(ABSOLUTE_PATH source BASE_DIRECTORY ${CMAKE_CURRENT_SOURCE_DIR} OUTPUT_VARIABLE sourcePath)
+    cmake_path(GET sourcePath FILENAME name)
+    set(spirv ${GROOT_OUTPUT_DIRECTORY}/${name}.spv)
+
+    add_custom_command(
+      OUTPUT ${spirv}
+      COMMAND ${CMAKE_COMMAND} -E make_directory ${GROOT_OUTPUT_DIRECTORY}
+      COMMAND ${GROOT_GLSLC} ${flags} -MD -MF ${spirv}.d -o ${spirv} ${sourcePath}
+      DEPENDS ${sourcePath}
+      DEPFILE ${spirv}.d
+      COMMENT "Compiling shader ${name}"
+      VERBATIM
+    )
+    list(APPEND outputs ${spirv})
+
+    if (GROOT_EMBED)
+      string(MAKE_C_IDENTIFIER ${name} identifier)
+      set(header ${embedDirectory}/${identifier}.hpp)
+
+      add_custom_command(
+        OUTPUT ${header}
+        COMMAND ${CMAKE_COMMAND} -DINPUT=${spirv} -DOUTPUT=${header} -DIDENTIFIER=${identifier} -P ${embedScript}
+        DEPENDS ${spirv} ${embedScript}
+        COMMENT "Embedding shader ${name}"
+        VERBATIM
+      )
+      list(APPEND outputs ${header})
+    endif()
+
+    if (GROOT_INSTALL_DESTINATION)
+      install(FILES ${spirv} DESTINATION ${GROOT_INSTALL_DESTINATION})
+    endif()
+  endforeach()
+
+  get_property(count GLOBAL PROPERTY GROOT_SHADER_TARGET_COUNT)
+  if (NOT count)
+    set(count 0)
+  endif()
+  math(EXPR count "${count} + 1")
+  set_property(GLOBAL PROPERTY GROOT_SHADER_TARGET_COUNT ${count})
+
+  add_custom_target(${target}_shaders_${count} DEPENDS ${outputs})
+  add_dependencies(${target} ${target}_shaders_${count})
+
+  if (GROOT_EMBED)
+    target_include_directories(${target} PRIVATE ${CMAKE_CURRENT_BINARY_DIR})
+  endif()
+endfunction()
@@ -122,6 +122,41 @@ enum class Filter {
   Linear
 };
 
+enum class CompareOp {
+  Never,
+  Less,
+  Equal,
+  LessOrEqual,
+  Greater,
+  NotEqual,
+  GreaterOrEqual,
+  Always
+};
+
+enum class VertexAttribute {
+  Position,
+  UV,
+  Normal
+};
+
+enum class VertexEncoding {
+  Float32,
+  Float16,
+  Snorm16,
+  Unorm16,
+  Snorm8,
+  Octahedral16
+};
+
+enum class BorderColor {
+  FloatTransparentBlack,
+  IntTransparentBlack,
+  FloatOpaqueBlack,
+  IntOpaqueBlack,
+  FloatOpaqueWhite,
+  IntOpaqueWhite
+};
+
 enum class ColorSpace {
   srgb_nonlinear        = 0,
   display_p3_nonlinear  = 1000104001,
@@ -269,7 +304,18 @@ enum class Key {
 enum class ImageType {
   one_dim,
   two_dim,
-  three_dim
+  three_dim,
+  cube,
+  one_dim_array,
+  two_dim_array,
+  cube_array
+};
+
+enum class CaptureFormat {
+  None,
+  PNG,
+  QOI,
+  Raw
 };
 
 } // namespace groot
\ No newline at end of file
@@ -8,6 +8,7 @@
 #include "object.hpp"
 #include "rid.hpp"
 #include "structs.hpp"
+#include "vertex_layout.hpp"
 
 #include <numbers>
 
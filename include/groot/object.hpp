@@ -1,7 +1,12 @@
 #pragma once
 
+#include "enums.hpp"
 #include "rid.hpp"
 
+#include <array>
+#include <optional>
+#include <vector>
+
 namespace groot {
 
 class alignas(64) Object {
@@ -11,7 +16,15 @@ class alignas(64) Object {
   RID m_id;
   RID m_mesh;
   RID m_pipeline;
-  RID m_set;
+  std::array<RID, 4> m_sets;
+  std::vector<unsigned char> m_pushConstants;
+
+  std::optional<CullMode> m_cullMode;
+  std::optional<DrawDirection> m_drawDirection;
+  std::optional<CompareOp> m_depthCompare;
+  std::optional<bool> m_depthTest;
+  std::optional<bool> m_depthWrite;
+  std::optional<bool> m_blend;
 
   public:
     Object() = default;
@@ -29,7 +42,20 @@ class alignas(64) Object {
 
     void set_mesh(const RID&);
     void set_pipeline(const RID&);
-    void set_descriptor_set(const RID&);
+    void set_descriptor_set(const RID&, unsigned int set = 0);
+    void set_cull_mode(CullMode);
+    void set_draw_direction(DrawDirection);
+    void set_depth_test(bool);
+    void set_depth_write(bool);
+    void set_depth_compare(CompareOp);
+    void set_blend(bool);
+    void set_push_constants(const std::vector<unsigned char>&);
+
+    template <typename T>
+    inline void set_push_constants(const T& data) {
+      const unsigned char * bytes = reinterpret_cast<const unsigned char *>(&data);
+      set_push_constants(std::vector<unsigned char>(bytes, bytes + sizeof(T)));
+    }
 };
 
 } // namespace groot
\ No newline at end of file
@@ -3,8 +3,11 @@
 #include "enums.hpp"
 #include "linalg.hpp"
 #include "rid.hpp"
+#include "vertex_layout.hpp"
 
+#include <map>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 namespace groot {
@@ -21,6 +24,27 @@ struct Settings {
   float fov = 70.0f;
   unsigned int flight_frames = 3;
   vec4 background_color = vec4(0.0f, 0.0f, 0.0f, 1.0f);
+  std::string cache_directory = "";
+  std::string pipeline_cache_path = "";
+  unsigned int worker_threads = 0;
+  bool hot_reload_shaders = false;
+  bool dynamic_pipeline_state = false;
+  bool graphics_pipeline_libraries = true;
+  bool optimize_pipeline_libraries = true;
+  bool bindless_descriptors = false;
+  bool descriptor_buffers = false;
+  std::vector<std::string> shader_include_directories = {};
+};
+
+struct ShaderDefine {
+  std::string name;
+  std::string value = "";
+};
+
+struct ShaderDesc {
+  ShaderType type = ShaderType::Vertex;
+  std::string path;
+  std::vector<ShaderDefine> defines = {};
 };
 
 struct Transform {
@@ -38,13 +62,30 @@ struct GraphicsPipelineShaders {
   RID tesselation_evaluation = RID();
 };
 
+struct SpecializationConstants {
+  std::map<unsigned int, std::vector<unsigned char>> values;
+
+  template <typename T>
+  SpecializationConstants& set(unsigned int id, const T& value) {
+    if constexpr (std::is_same_v<T, bool>)
+      return set(id, static_cast<unsigned int>(value));
+
+    const unsigned char * bytes = reinterpret_cast<const unsigned char *>(&value);
+    values[id] = std::vector<unsigned char>(bytes, bytes + sizeof(T));
+    return *this;
+  }
+};
+
 struct GraphicsPipelineSettings {
   MeshType mesh_type = MeshType::Solid;
   CullMode cull_mode = CullMode::Back;
   DrawDirection draw_direction = DrawDirection::CounterClockwise;
   bool enable_depth_test = true;
   bool enable_depth_write = true;
+  CompareOp depth_compare = CompareOp::Less;
   bool enable_blend = true;
+  VertexFormat vertex_format = StandardVertex::format();
+  SpecializationConstants specialization = {};
 };
 
 struct SamplerSettings {
@@ -54,11 +95,39 @@ struct SamplerSettings {
   SampleMode mode_v = SampleMode::Repeat;
   SampleMode mode_w = SampleMode::Repeat;
   bool anisotropic_filtering = true;
+  float mip_lod_bias = 0.0f;
+  bool enable_compare = false;
+  CompareOp compare_op = CompareOp::LessOrEqual;
+  BorderColor border_color = BorderColor::FloatTransparentBlack;
+
+  struct Hash {
+    std::size_t operator()(const SamplerSettings&) const;
+  };
+
+  bool operator==(const SamplerSettings&) const = default;
+};
+
+struct ImageRegion {
+  unsigned int x = 0;
+  unsigned int y = 0;
+  unsigned int z = 0;
+  unsigned int width = 0;
+  unsigned int height = 0;
+  unsigned int depth = 0;
+  unsigned int layer = 0;
+};
+
+struct CaptureSettings {
+  CaptureFormat format = CaptureFormat::None;
+  std::string directory = "capture";
+  std::string prefix = "frame";
+  unsigned int max_queued_frames = 4;
 };
 
 struct ComputeCommand {
   RID pipeline = RID();
   RID descriptor_set = RID();
+  std::vector<RID> push_descriptors = {};
   std::vector<unsigned char> push_constants;
   std::tuple<unsigned int, unsigned int, unsigned int> work_groups = { 1, 1, 1 };
   bool barrier = false;
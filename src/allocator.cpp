@@ -6,6 +6,7 @@ namespace groot {
 
 Allocator::Allocator(const VulkanContext * context, unsigned int apiVersion) {
   VmaAllocatorCreateInfo createInfo{
+    .flags            = context->supportsDescriptorBuffers() ? VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT : 0u,
     .physicalDevice   = context->gpu(),
     .device           = context->device(),
     .instance         = context->instance(),
@@ -48,6 +49,7 @@ vk::Buffer Allocator::allocateBuffer(const vk::BufferCreateInfo& bufferCreateInf
     Log::runtime_error(std::format("failed to create buffer: {}", vk::to_string(res)));
 
   m_buffers[buffer] = allocation;
+  m_bufferRanges[buffer] = bufferCreateInfo.size;
   return buffer;
 }
 
@@ -66,10 +68,23 @@ void Allocator::unmapBuffer(const vk::Buffer& buffer) {
   vmaUnmapMemory(m_allocator, alloc);
 }
 
+void Allocator::invalidateBuffer(const vk::Buffer& buffer) {
+  VmaAllocation alloc = m_buffers.at(buffer);
+  if (vmaInvalidateAllocation(m_allocator, alloc, 0, VK_WHOLE_SIZE) != VK_SUCCESS)
+    Log::runtime_error("failed to invalidate buffer memory");
+}
+
+void Allocator::flushBuffer(const vk::Buffer& buffer, vk::DeviceSize offset, vk::DeviceSize size) {
+  VmaAllocation alloc = m_buffers.at(buffer);
+  if (vmaFlushAllocation(m_allocator, alloc, offset, size) != VK_SUCCESS)
+    Log::runtime_error("failed to flush buffer memory");
+}
+
 void Allocator::destroyBuffer(const vk::Buffer& buffer) {
   VmaAllocation alloc = m_buffers.at(buffer);
   vmaDestroyBuffer(m_allocator, buffer, alloc);
   m_buffers.erase(buffer);
+  m_bufferRanges.erase(buffer);
 }
 
 unsigned int Allocator::bufferSize(const vk::Buffer& buffer) const {
@@ -81,6 +96,10 @@ unsigned int Allocator::bufferSize(const vk::Buffer& buffer) const {
   return info.size;
 }
 
+vk::DeviceSize Allocator::bufferRange(const vk::Buffer& buffer) const {
+  return m_bufferRanges.at(buffer);
+}
+
 vk::Image Allocator::allocateImage(const vk::ImageCreateInfo& createInfo, VmaMemoryUsage memoryUsage) {
   VmaAllocationCreateInfo allocationCreateInfo{
     .usage          = memoryUsage,
@@ -0,0 +1,74 @@
+#include "src/include/atlas_packer.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <numeric>
+
+namespace groot {
+
+AtlasPacker::AtlasPacker(unsigned int maxSize, unsigned int padding) : m_maxSize(maxSize), m_padding(padding) {}
+
+AtlasLayout AtlasPacker::pack(const std::vector<std::pair<unsigned int, unsigned int>>& sizes) const {
+  if (sizes.empty()) return {};
+
+  std::vector<unsigned int> order(sizes.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&sizes](unsigned int lhs, unsigned int rhs) {
+    return sizes[lhs].second > sizes[rhs].second;
+  });
+
+  unsigned long area = 0;
+  unsigned int widest = 0;
+  for (const auto& [width, height] : sizes) {
+    area += static_cast<unsigned long>(width + m_padding) * (height + m_padding);
+    widest = std::max(widest, width + m_padding);
+  }
+
+  unsigned int width = std::bit_ceil(std::max(
+    widest,
+    static_cast<unsigned int>(std::ceil(std::sqrt(static_cast<double>(area))))
+  ));
+
+  AtlasLayout layout;
+  for (; width <= m_maxSize; width *= 2) {
+    unsigned int height = shelve(width, sizes, order, layout.offsets);
+    if (height > m_maxSize) continue;
+
+    if (height <= width || width * 2 > m_maxSize) {
+      layout.width = width;
+      layout.height = height;
+      return layout;
+    }
+  }
+
+  return {};
+}
+
+unsigned int AtlasPacker::shelve(
+  unsigned int width,
+  const std::vector<std::pair<unsigned int, unsigned int>>& sizes,
+  const std::vector<unsigned int>& order,
+  std::vector<std::pair<unsigned int, unsigned int>>& offsets
+) const {
+  offsets.assign(sizes.size(), { 0, 0 });
+
+  unsigned int x = 0, y = 0, shelfHeight = 0;
+  for (unsigned int index : order) {
+    auto [w, h] = sizes[index];
+
+    if (x + w > width) {
+      y += shelfHeight;
+      x = 0;
+      shelfHeight = 0;
+    }
+
+    offsets[index] = { x, y };
+    x += w + m_padding;
+    shelfHeight = std::max(shelfHeight, h + m_padding);
+  }
+
+  return y + shelfHeight;
+}
+
+} // namespace groot
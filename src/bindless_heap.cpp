@@ -0,0 +1,129 @@
+#include "src/include/bindless_heap.hpp"
+#include "src/include/vulkan_context.hpp"
+
+#include <algorithm>
+
+namespace groot {
+
+BindlessHeap::BindlessHeap(const VulkanContext * context, unsigned int capacity) {
+  auto properties = context->gpu().getProperties2<vk::PhysicalDeviceProperties2, vk::PhysicalDeviceDescriptorIndexingProperties>();
+  const auto& limits = properties.get<vk::PhysicalDeviceDescriptorIndexingProperties>();
+
+  m_capacity = std::min({
+    capacity,
+    limits.maxDescriptorSetUpdateAfterBindSampledImages,
+    limits.maxDescriptorSetUpdateAfterBindStorageImages,
+    limits.maxDescriptorSetUpdateAfterBindStorageBuffers,
+    limits.maxPerStageDescriptorUpdateAfterBindSampledImages,
+    limits.maxPerStageDescriptorUpdateAfterBindStorageImages,
+    limits.maxPerStageDescriptorUpdateAfterBindStorageBuffers,
+    limits.maxPerStageUpdateAfterBindResources / 3
+  });
+
+  for (auto type : { vk::DescriptorType::eCombinedImageSampler, vk::DescriptorType::eStorageImage, vk::DescriptorType::eStorageBuffer }) {
+    m_bindings.emplace_back(vk::DescriptorSetLayoutBinding{
+      .binding          = static_cast<unsigned int>(m_bindings.size()),
+      .descriptorType   = type,
+      .descriptorCount  = m_capacity,
+      .stageFlags       = vk::ShaderStageFlagBits::eAll
+    });
+  }
+
+  std::vector<vk::DescriptorBindingFlags> flags(m_bindings.size(),
+    vk::DescriptorBindingFlagBits::ePartiallyBound |
+    vk::DescriptorBindingFlagBits::eUpdateAfterBind |
+    vk::DescriptorBindingFlagBits::eUpdateUnusedWhilePending
+  );
+
+  vk::DescriptorSetLayoutBindingFlagsCreateInfo bindingFlags{
+    .bindingCount   = static_cast<unsigned int>(flags.size()),
+    .pBindingFlags  = flags.data()
+  };
+
+  m_layout = context->device().createDescriptorSetLayout(vk::DescriptorSetLayoutCreateInfo{
+    .pNext        = &bindingFlags,
+    .flags        = vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPool,
+    .bindingCount = static_cast<unsigned int>(m_bindings.size()),
+    .pBindings    = m_bindings.data()
+  });
+
+  std::vector<vk::DescriptorPoolSize> sizes;
+  for (const auto& binding : m_bindings) {
+    sizes.emplace_back(vk::DescriptorPoolSize{
+      .type             = binding.descriptorType,
+      .descriptorCount  = m_capacity
+    });
+  }
+
+  m_pool = context->device().createDescriptorPool(vk::DescriptorPoolCreateInfo{
+    .flags          = vk::DescriptorPoolCreateFlagBits::eUpdateAfterBind,
+    .maxSets        = 1,
+    .poolSizeCount  = static_cast<unsigned int>(sizes.size()),
+    .pPoolSizes     = sizes.data()
+  });
+
+  m_set = context->device().allocateDescriptorSets(vk::DescriptorSetAllocateInfo{
+    .descriptorPool     = m_pool,
+    .descriptorSetCount = 1,
+    .pSetLayouts        = &m_layout
+  })[0];
+}
+
+const vk::DescriptorSetLayout& BindlessHeap::layout() const {
+  return m_layout;
+}
+
+const vk::DescriptorSet& BindlessHeap::set() const {
+  return m_set;
+}
+
+const std::vector<vk::DescriptorSetLayoutBinding>& BindlessHeap::bindings() const {
+  return m_bindings;
+}
+
+unsigned int BindlessHeap::capacity() const {
+  return m_capacity;
+}
+
+unsigned int BindlessHeap::acquire() {
+  if (!m_free.empty()) {
+    unsigned int index = m_free.back();
+    m_free.pop_back();
+    return index;
+  }
+
+  return m_next < m_capacity ? m_next++ : 0;
+}
+
+void BindlessHeap::release(unsigned int index) {
+  if (index != 0) m_free.emplace_back(index);
+}
+
+void BindlessHeap::write(const vk::Device& device, unsigned int binding, unsigned int index, const vk::DescriptorImageInfo& info) const {
+  device.updateDescriptorSets(vk::WriteDescriptorSet{
+    .dstSet           = m_set,
+    .dstBinding       = binding,
+    .dstArrayElement  = index,
+    .descriptorCount  = 1,
+    .descriptorType   = m_bindings[binding].descriptorType,
+    .pImageInfo       = &info
+  }, nullptr);
+}
+
+void BindlessHeap::write(const vk::Device& device, unsigned int index, const vk::DescriptorBufferInfo& info) const {
+  device.updateDescriptorSets(vk::WriteDescriptorSet{
+    .dstSet           = m_set,
+    .dstBinding       = storageBufferBinding,
+    .dstArrayElement  = index,
+    .descriptorCount  = 1,
+    .descriptorType   = vk::DescriptorType::eStorageBuffer,
+    .pBufferInfo      = &info
+  }, nullptr);
+}
+
+void BindlessHeap::destroy(const vk::Device& device) {
+  device.destroyDescriptorPool(m_pool);
+  device.destroyDescriptorSetLayout(m_layout);
+}
+
+} // namespace groot
@@ -0,0 +1,101 @@
+#include "src/include/descriptor_allocator.hpp"
+#include "src/include/hash.hpp"
+
+#include <algorithm>
+
+namespace groot {
+
+DescriptorAllocator::DescriptorAllocator(unsigned int initialSets, unsigned int maxSets)
+: m_initialSets(std::max(initialSets, 1u)), m_maxSets(std::max(maxSets, initialSets)) {}
+
+DescriptorAllocation DescriptorAllocator::allocate(
+  const vk::Device& device,
+  const vk::DescriptorSetLayout& layout,
+  const std::vector<vk::DescriptorSetLayoutBinding>& bindings
+) {
+  std::vector<vk::DescriptorPoolSize> sizes;
+  for (const auto& binding : bindings) {
+    auto it = std::find_if(sizes.begin(), sizes.end(), [&binding](const auto& size) { return size.type == binding.descriptorType; });
+    if (it == sizes.end())
+      sizes.emplace_back(vk::DescriptorPoolSize{ .type = binding.descriptorType, .descriptorCount = binding.descriptorCount });
+    else
+      it->descriptorCount += binding.descriptorCount;
+  }
+  std::sort(sizes.begin(), sizes.end(), [](const auto& lhs, const auto& rhs) { return lhs.type < rhs.type; });
+
+  unsigned long key = fnv1aOffset;
+  for (const auto& size : sizes) {
+    key = fnv1aValue(size.type, key);
+    key = fnv1aValue(size.descriptorCount, key);
+  }
+
+  PoolFamily& family = m_families[key];
+  if (family.pools.empty()) family.sizes = std::move(sizes);
+
+  Pool& pool = acquire(device, family);
+  ++pool.allocated;
+  ++pool.live;
+
+  return DescriptorAllocation{
+    .set      = device.allocateDescriptorSets(vk::DescriptorSetAllocateInfo{
+      .descriptorPool     = pool.pool,
+      .descriptorSetCount = 1,
+      .pSetLayouts        = &layout
+    })[0],
+    .pool     = pool.pool,
+    .poolKey  = key
+  };
+}
+
+void DescriptorAllocator::free(const vk::Device& device, const DescriptorAllocation& allocation) {
+  auto family = m_families.find(allocation.poolKey);
+  if (family == m_families.end()) return;
+
+  auto pool = std::find_if(family->second.pools.begin(), family->second.pools.end(), [&allocation](const Pool& pool) {
+    return pool.pool == allocation.pool;
+  });
+  if (pool == family->second.pools.end() || --pool->live > 0) return;
+
+  device.resetDescriptorPool(pool->pool);
+  pool->allocated = 0;
+}
+
+void DescriptorAllocator::destroy(const vk::Device& device) {
+  for (auto& [key, family] : m_families) {
+    for (auto& pool : family.pools)
+      device.destroyDescriptorPool(pool.pool);
+  }
+  m_families.clear();
+}
+
+unsigned int DescriptorAllocator::poolCount() const {
+  unsigned int count = 0;
+  for (const auto& [key, family] : m_families)
+    count += family.pools.size();
+  return count;
+}
+
+DescriptorAllocator::Pool& DescriptorAllocator::acquire(const vk::Device& device, PoolFamily& family) {
+  for (auto& pool : family.pools) {
+    if (pool.allocated < pool.capacity) return pool;
+  }
+
+  unsigned int capacity = family.pools.empty() ? m_initialSets : std::min(family.pools.back().capacity * 2, m_maxSets);
+
+  std::vector<vk::DescriptorPoolSize> sizes = family.sizes;
+  for (auto& size : sizes)
+    size.descriptorCount *= capacity;
+
+  family.pools.emplace_back(Pool{
+    .pool     = device.createDescriptorPool(vk::DescriptorPoolCreateInfo{
+      .maxSets        = capacity,
+      .poolSizeCount  = static_cast<unsigned int>(sizes.size()),
+      .pPoolSizes     = sizes.data()
+    }),
+    .capacity = capacity
+  });
+
+  return family.pools.back();
+}
+
+} // namespace groot
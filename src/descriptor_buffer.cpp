@@ -0,0 +1,150 @@
+#include "src/include/descriptor_buffer.hpp"
+#include "src/include/allocator.hpp"
+#include "src/include/log.hpp"
+#include "src/include/vulkan_context.hpp"
+
+#include <algorithm>
+
+namespace groot {
+
+DescriptorBuffer::DescriptorBuffer(const VulkanContext * context, Allocator * allocator, vk::DeviceSize size) {
+  const auto& properties = context->descriptorBufferProperties();
+  m_alignment = std::max<vk::DeviceSize>(properties.descriptorBufferOffsetAlignment, 1);
+  m_size = std::min({
+    size,
+    properties.maxResourceDescriptorBufferRange,
+    properties.maxSamplerDescriptorBufferRange,
+    properties.resourceDescriptorBufferAddressSpaceSize,
+    properties.samplerDescriptorBufferAddressSpaceSize
+  });
+
+  m_buffer = allocator->allocateBuffer(vk::BufferCreateInfo{
+    .size         = m_size,
+    .usage        = vk::BufferUsageFlagBits::eResourceDescriptorBufferEXT |
+                    vk::BufferUsageFlagBits::eSamplerDescriptorBufferEXT |
+                    vk::BufferUsageFlagBits::eShaderDeviceAddress,
+    .sharingMode  = vk::SharingMode::eExclusive
+  });
+
+  m_data = reinterpret_cast<unsigned char *>(allocator->mapBuffer(m_buffer));
+  m_address = context->device().getBufferAddress(vk::BufferDeviceAddressInfo{ .buffer = m_buffer });
+  m_free[0] = m_size;
+}
+
+DescriptorAllocation DescriptorBuffer::allocate(const VulkanContext * context, const vk::DescriptorSetLayout& layout) {
+  vk::DeviceSize size = std::max<vk::DeviceSize>((context->descriptorSetLayoutSize(layout) + m_alignment - 1) / m_alignment * m_alignment, m_alignment);
+
+  auto it = std::find_if(m_free.begin(), m_free.end(), [size](const auto& range) { return range.second >= size; });
+  if (it == m_free.end())
+    Log::runtime_error(std::format("descriptor buffer is out of space. {} of {} bytes are in use", used(), m_size));
+
+  auto [offset, available] = *it;
+  m_free.erase(it);
+  if (available > size) m_free[offset + size] = available - size;
+  m_allocated[offset] = size;
+
+  return DescriptorAllocation{ .offset = offset };
+}
+
+void DescriptorBuffer::write(
+  const VulkanContext * context,
+  Allocator * allocator,
+  const DescriptorAllocation& allocation,
+  const vk::DescriptorSetLayout& layout,
+  const vk::WriteDescriptorSet& write
+) {
+  const auto& properties = context->descriptorBufferProperties();
+
+  vk::DescriptorAddressInfoEXT address{};
+  vk::DescriptorGetInfoEXT info{ .type = write.descriptorType };
+  std::size_t size = 0;
+
+  switch (write.descriptorType) {
+    case vk::DescriptorType::eUniformBuffer:
+    case vk::DescriptorType::eStorageBuffer: {
+      const vk::DescriptorBufferInfo& buffer = *write.pBufferInfo;
+      address = vk::DescriptorAddressInfoEXT{
+        .address  = context->device().getBufferAddress(vk::BufferDeviceAddressInfo{ .buffer = buffer.buffer }) + buffer.offset,
+        .range    = buffer.range == vk::WholeSize ? allocator->bufferRange(buffer.buffer) - buffer.offset : buffer.range
+      };
+
+      if (write.descriptorType == vk::DescriptorType::eUniformBuffer) {
+        info.data.pUniformBuffer = &address;
+        size = properties.uniformBufferDescriptorSize;
+      }
+      else {
+        info.data.pStorageBuffer = &address;
+        size = properties.storageBufferDescriptorSize;
+      }
+
+      break;
+    }
+    case vk::DescriptorType::eStorageImage:
+      info.data.pStorageImage = write.pImageInfo;
+      size = properties.storageImageDescriptorSize;
+      break;
+    case vk::DescriptorType::eCombinedImageSampler:
+      info.data.pCombinedImageSampler = write.pImageInfo;
+      size = properties.combinedImageSamplerDescriptorSize;
+      break;
+    default:
+      Log::warn(std::format("{} descriptors cannot be written to the descriptor buffer", vk::to_string(write.descriptorType)));
+      return;
+  }
+
+  vk::DeviceSize offset = allocation.offset + context->descriptorBindingOffset(layout, write.dstBinding);
+  context->getDescriptor(info, size, m_data + offset);
+  allocator->flushBuffer(m_buffer, offset, size);
+}
+
+void DescriptorBuffer::free(const DescriptorAllocation& allocation) {
+  auto allocated = m_allocated.find(allocation.offset);
+  if (allocated == m_allocated.end()) return;
+
+  auto [offset, size] = *allocated;
+  m_allocated.erase(allocated);
+
+  auto next = m_free.find(offset + size);
+  if (next != m_free.end()) {
+    size += next->second;
+    m_free.erase(next);
+  }
+
+  auto it = m_free.emplace(offset, size).first;
+  if (it != m_free.begin()) {
+    auto prev = std::prev(it);
+    if (prev->first + prev->second == offset) {
+      prev->second += size;
+      m_free.erase(it);
+    }
+  }
+}
+
+void DescriptorBuffer::destroy(Allocator * allocator) {
+  if (!m_buffer) return;
+
+  allocator->unmapBuffer(m_buffer);
+  allocator->destroyBuffer(m_buffer);
+  m_buffer = nullptr;
+  m_data = nullptr;
+  m_free.clear();
+  m_allocated.clear();
+}
+
+vk::DescriptorBufferBindingInfoEXT DescriptorBuffer::binding() const {
+  return vk::DescriptorBufferBindingInfoEXT{
+    .address  = m_address,
+    .usage    = vk::BufferUsageFlagBits::eResourceDescriptorBufferEXT |
+                vk::BufferUsageFlagBits::eSamplerDescriptorBufferEXT |
+                vk::BufferUsageFlagBits::eShaderDeviceAddress
+  };
+}
+
+vk::DeviceSize DescriptorBuffer::used() const {
+  vk::DeviceSize total = 0;
+  for (const auto& [offset, size] : m_allocated)
+    total += size;
+  return total;
+}
+
+} // namespace groot
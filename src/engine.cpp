@@ -1,11 +1,23 @@
 #include "src/include/allocator.hpp"
+#include "src/include/atlas_packer.hpp"
+#include "src/include/bindless_heap.hpp"
+#include "src/include/descriptor_allocator.hpp"
+#include "src/include/descriptor_buffer.hpp"
 #include "src/include/engine.hpp"
+#include "src/include/frame_capture.hpp"
+#include "src/include/hash.hpp"
 #include "src/include/input_mananger.hpp"
 #include "src/include/object.hpp"
+#include "src/include/readback_ring.hpp"
 #include "src/include/renderer.hpp"
+#ifdef GROOT_SHADER_COMPILER
 #include "src/include/shader_compiler.hpp"
+#endif
+#include "src/include/shader_reflection.hpp"
+#include "src/include/shader_watcher.hpp"
 #include "src/include/stb_image.h"
 #include "src/include/structs.hpp"
+#include "src/include/thread_pool.hpp"
 #include "src/include/tiny_obj_loader.h"
 #include "src/include/vulkan_context.hpp"
 
@@ -13,6 +25,8 @@
 #include <imgui.h>
 
 #include <chrono>
+#include <filesystem>
+#include <fstream>
 
 namespace groot {
 
@@ -39,13 +53,44 @@ Engine::Engine(const Settings& settings) : m_settings(settings) {
   };
 
   m_context->chooseGPU(m_settings.gpu_index, requiredExtensions);
-  m_context->createDevice(requiredExtensions);
+  m_context->createDevice(requiredExtensions, m_settings);
   m_context->createCommandPools();
+  m_context->createPipelineCache(m_settings.pipeline_cache_path);
   m_context->printInfo();
 
   m_allocator = new Allocator(m_context, m_context->gpu().getProperties().apiVersion);
-  m_compiler = new ShaderCompiler();
+#ifdef GROOT_SHADER_COMPILER
+  m_compiler = new ShaderCompiler(m_settings.cache_directory, m_settings.shader_include_directories);
+#endif
+  m_workers = new ThreadPool(m_settings.worker_threads);
+  if (m_settings.hot_reload_shaders)
+    m_shaderWatcher = new ShaderWatcher;
   m_renderer = new Renderer(m_window, m_context, m_allocator, m_settings);
+  m_readbacks = new ReadbackRing(m_settings.flight_frames);
+
+  m_renderTarget = new ImageHandle;
+  m_renderTarget->format = m_renderer->colorFormat();
+  m_renderTarget->extent = vk::Extent3D{ m_renderer->extent().first, m_renderer->extent().second, 1 };
+  m_descriptors = new DescriptorAllocator(16, 1024);
+
+  if (m_context->supportsDescriptorBuffers()) {
+    m_descriptorBuffer = new DescriptorBuffer(m_context, m_allocator, 4 << 20);
+    m_renderer->setDescriptorBuffer(m_descriptorBuffer->binding());
+  }
+
+  if (m_context->supportsBindless()) {
+    m_bindless = new BindlessHeap(m_context, 4096);
+
+    DescriptorSetHandle * set = new DescriptorSetHandle;
+    set->layout = m_bindless->layout();
+    set->set = m_bindless->set();
+    set->allocation.set = set->set;
+    set->bindings = m_bindless->bindings();
+    set->layoutKey = fnv1a(std::string_view("bindless"));
+
+    m_bindlessSet = RID(m_nextRID++, ResourceType::DescriptorSet);
+    m_resources[m_bindlessSet] = reinterpret_cast<unsigned long>(set);
+  }
 
   m_inputManager = new InputManager;
   glfwSetWindowUserPointer(m_window, m_inputManager);
@@ -57,17 +102,30 @@ Engine::Engine(const Settings& settings) : m_settings(settings) {
 }
 
 Engine::~Engine() {
+  delete m_shaderWatcher;
+  delete m_workers;
+  flushDeletions(true);
+
   for (auto& [rid, handle] : m_resources) {
     switch (rid.m_type) {
       case ResourceType::Invalid:
         break;
-      case ResourceType::Shader:
-        m_context->device().destroyShaderModule(reinterpret_cast<VkShaderModule>(handle));
+      case ResourceType::Shader: {
+        ShaderHandle * shader = reinterpret_cast<ShaderHandle *>(handle);
+
+        m_context->device().destroyShaderModule(shader->module);
+        delete shader;
+
         break;
+      }
       case ResourceType::Pipeline: {
         PipelineHandle * pipeline = reinterpret_cast<PipelineHandle *>(handle);
+        if (pipeline->pending.valid()) pipeline->pipeline = pipeline->pending.get();
+        if (pipeline->optimized.valid()) m_context->device().destroyPipeline(pipeline->optimized.get());
 
-        m_context->device().destroyPipelineLayout(pipeline->layout);
+        releasePipelineLibraries(pipeline);
+        releasePipelineLayout(pipeline->layoutKey);
+        for (unsigned long key : pipeline->setLayoutKeys) releaseSetLayout(key);
         m_context->device().destroyPipeline(pipeline->pipeline);
         delete pipeline;
 
@@ -76,8 +134,8 @@ Engine::~Engine() {
       case ResourceType::DescriptorSet: {
         DescriptorSetHandle * set = reinterpret_cast<DescriptorSetHandle *>(handle);
 
-        m_context->device().destroyDescriptorSetLayout(set->layout);
-        m_context->device().destroyDescriptorPool(set->pool);
+        if (set->updateTemplate) m_context->device().destroyDescriptorUpdateTemplate(set->updateTemplate);
+        releaseSetLayout(set->layoutKey);
         delete set;
 
         break;
@@ -114,9 +172,25 @@ Engine::~Engine() {
     }
   }
 
+  m_readbacks->destroy(m_allocator);
+  delete m_readbacks;
+  delete m_renderTarget;
+
+  m_descriptors->destroy(m_context->device());
+  delete m_descriptors;
+
+  if (m_descriptorBuffer) m_descriptorBuffer->destroy(m_allocator);
+  delete m_descriptorBuffer;
+
+  if (m_bindless) m_bindless->destroy(m_context->device());
+  delete m_bindless;
+
   m_renderer->destroy(m_context, m_allocator);
   delete m_renderer;
 
+#ifdef GROOT_SHADER_COMPILER
+  delete m_compiler;
+#endif
   delete m_allocator;
   delete m_context;
   delete m_inputManager;
@@ -191,11 +265,6 @@ void Engine::release_cursor() const {
 }
 
 RID Engine::render_target() {
-  if (m_renderTarget == nullptr) {
-    Log::warn("Tried to get render target RID when no render target has been created yet");
-    return RID();
-  }
-
   return RID(0, ResourceType::RenderTarget);
 }
 
@@ -207,6 +276,14 @@ unsigned int Engine::frame_index() const {
   return m_renderer->frameIndex();
 }
 
+bool Engine::dynamic_pipeline_state() const {
+  return m_context->supportsDynamicState();
+}
+
+bool Engine::descriptor_buffers() const {
+  return m_descriptorBuffer != nullptr;
+}
+
 void Engine::translate_camera(const vec3& delta) {
   m_cameraEye = m_cameraEye + delta;
   m_cameraTarget = m_cameraTarget + delta;
@@ -227,13 +304,35 @@ void Engine::rotate_camera(float pitch, float yaw) {
   m_cameraTarget = m_cameraEye + dist * dir;
 }
 
-void Engine::run(std::function<void(double)> pre_draw, std::function<void(double)> post_draw) {
+void Engine::run(std::function<void(double)> pre_draw, std::function<void(double)> post_draw, const CaptureSettings& capture) {
+  FrameCapture * frameCapture = nullptr;
+  if (capture.format != CaptureFormat::None) {
+    CaptureSettings captureSettings = capture;
+    vk::Format colorFormat = m_renderer->colorFormat();
+
+    if (vk::blockSize(colorFormat) != 4 && captureSettings.format != CaptureFormat::Raw) {
+      Log::warn(std::format("cannot encode {} frames. capturing raw frames instead", vk::to_string(colorFormat)));
+      captureSettings.format = CaptureFormat::Raw;
+    }
+
+    auto [width, height] = m_renderer->extent();
+    frameCapture = new FrameCapture(captureSettings, width, height,
+      colorFormat == vk::Format::eB8G8R8A8Srgb || colorFormat == vk::Format::eB8G8R8A8Unorm
+    );
+  }
+
   while (!glfwWindowShouldClose(m_window)) {
     updateTimes();
     m_inputManager->reset();
     glfwPollEvents();
 
     m_renderer->prepFrame(m_context, m_resources);
+    m_readbacks->resolve(m_allocator, m_renderer->frameIndex());
+    if (frameCapture) frameCapture->collect();
+    resolvePipelines();
+    reloadShaders();
+    refreshDescriptorSets();
+    flushDeletions(false);
 
     m_renderer->beginDispatch(m_context, m_storageTextures);
     pre_draw(m_frameTime);
@@ -241,27 +340,24 @@ void Engine::run(std::function<void(double)> pre_draw, std::function<void(double
 
     unsigned int imgIndex = m_renderer->draw(m_context, m_storageTextures, m_resources, m_scene);
 
-    auto [drawImage, drawView] = m_renderer->drawTarget(imgIndex);
-    m_drawOutput = new ImageHandle;
-    m_drawOutput->image = drawImage;
-    m_drawOutput->view = drawView;
-
     auto [renderImage, renderView] = m_renderer->renderTarget(imgIndex);
-    m_renderTarget = new ImageHandle;
     m_renderTarget->image = renderImage;
     m_renderTarget->view = renderView;
 
     m_renderer->beginPostProcess(m_context, imgIndex);
     post_draw(m_frameTime);
+    if (frameCapture) frameCapture->track(read_image_async(render_target()));
     m_renderer->endPostProcess(m_context, imgIndex);
 
     m_renderer->drawUI(m_context, imgIndex, m_guis);
     m_renderer->submit(m_context, imgIndex);
 
-    delete m_drawOutput;
-    delete m_renderTarget;
+    ++m_frameCount;
   }
   m_context->device().waitIdle();
+  flushDeletions(true);
+  m_readbacks->resolveAll(m_allocator);
+  delete frameCapture;
 }
 
 RID Engine::create_uniform_buffer(unsigned int size) {
@@ -272,7 +368,7 @@ RID Engine::create_uniform_buffer(unsigned int size) {
 
   vk::Buffer buffer = m_allocator->allocateBuffer(vk::BufferCreateInfo{
     .size         = size,
-    .usage        = vk::BufferUsageFlagBits::eUniformBuffer,
+    .usage        = m_descriptorBuffer ? vk::BufferUsageFlagBits::eUniformBuffer | vk::BufferUsageFlagBits::eShaderDeviceAddress : vk::BufferUsageFlagBits::eUniformBuffer,
     .sharingMode  = vk::SharingMode::eExclusive
   });
 
@@ -290,12 +386,13 @@ RID Engine::create_storage_buffer(unsigned int size) {
 
   vk::Buffer buffer = m_allocator->allocateBuffer(vk::BufferCreateInfo{
     .size         = size,
-    .usage        = vk::BufferUsageFlagBits::eStorageBuffer,
+    .usage        = m_descriptorBuffer ? vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eShaderDeviceAddress : vk::BufferUsageFlagBits::eStorageBuffer,
     .sharingMode  = vk::SharingMode::eExclusive
   });
 
   RID rid = RID(m_nextRID++, ResourceType::StorageBuffer);
   m_resources[rid] = reinterpret_cast<unsigned long>(static_cast<VkBuffer>(buffer));
+  registerBindless(rid);
 
   return rid;
 }
@@ -311,6 +408,8 @@ void Engine::destroy_buffer(RID& rid) {
     return;
   }
 
+  releaseBindless(rid);
+
   vk::Buffer buffer = reinterpret_cast<VkBuffer>(m_resources.at(rid));
   m_allocator->destroyBuffer(buffer);
   m_resources.erase(rid);
@@ -319,24 +418,41 @@ void Engine::destroy_buffer(RID& rid) {
 }
 
 RID Engine::create_sampler(const SamplerSettings& settings) {
+  if (auto it = m_samplerCache.find(settings); it != m_samplerCache.end()) {
+    ++m_refCounts.at(it->second);
+    return it->second;
+  }
+
   bool anisotropy = settings.anisotropic_filtering;
-  if (anisotropy && m_context->supportsAnisotropy()) {
+  if (anisotropy && !m_context->supportsAnisotropy()) {
     Log::warn("GPU does not support anisotropic filtering. sampler will not use this feature");
     anisotropy = false;
   }
 
+  const vk::PhysicalDeviceLimits limits = m_context->gpu().getProperties().limits;
+
+  float lodBias = std::clamp(settings.mip_lod_bias, -limits.maxSamplerLodBias, limits.maxSamplerLodBias);
+  if (lodBias != settings.mip_lod_bias)
+    Log::warn(std::format("mip lod bias {} exceeds the GPU limit. clamping to {}", settings.mip_lod_bias, lodBias));
+
   vk::Sampler sampler = m_context->device().createSampler(vk::SamplerCreateInfo{
     .magFilter        = static_cast<vk::Filter>(settings.mag_filter),
     .minFilter        = static_cast<vk::Filter>(settings.min_filter),
     .addressModeU     = static_cast<vk::SamplerAddressMode>(settings.mode_u),
     .addressModeV     = static_cast<vk::SamplerAddressMode>(settings.mode_v),
     .addressModeW     = static_cast<vk::SamplerAddressMode>(settings.mode_w),
-    .anisotropyEnable = true,
-    .maxAnisotropy    = m_context->gpu().getProperties().limits.maxSamplerAnisotropy
+    .mipLodBias       = lodBias,
+    .anisotropyEnable = anisotropy,
+    .maxAnisotropy    = anisotropy ? limits.maxSamplerAnisotropy : 1.0f,
+    .compareEnable    = settings.enable_compare,
+    .compareOp        = static_cast<vk::CompareOp>(settings.compare_op),
+    .borderColor      = static_cast<vk::BorderColor>(settings.border_color)
   });
 
   RID rid(m_nextRID++, ResourceType::Sampler);
   m_resources[rid] = reinterpret_cast<unsigned long>(static_cast<VkSampler>(sampler));
+  m_samplerCache[settings] = rid;
+  m_refCounts[rid] = 1;
 
   return rid;
 }
@@ -352,6 +468,12 @@ void Engine::destroy_sampler(RID& rid) {
     return;
   }
 
+  if (m_refCounts.at(rid) > 1) {
+    --m_refCounts.at(rid);
+    rid.invalidate();
+    return;
+  }
+
   if (m_busySamplers.contains(rid)) {
     Log::warn("cannot destroy sampler -- sampler is in use");
     return;
@@ -359,11 +481,17 @@ void Engine::destroy_sampler(RID& rid) {
 
   m_context->device().destroySampler(reinterpret_cast<VkSampler>(m_resources.at(rid)));
   m_resources.erase(rid);
+  m_refCounts.erase(rid);
+  std::erase_if(m_samplerCache, [&rid](const auto& entry) { return entry.second == rid; });
 
   rid.invalidate();
 }
 
 RID Engine::create_storage_image(unsigned int width, unsigned int height, ImageType type, Format format) {
+  return create_storage_image(width, height, defaultLayers(type), type, format);
+}
+
+RID Engine::create_storage_image(unsigned int width, unsigned int height, unsigned int depth, ImageType type, Format format) {
   if (format == Format::undefined) {
     Log::warn("tried to create storage image with undefined format");
     return RID();
@@ -379,86 +507,9 @@ RID Engine::create_storage_image(unsigned int width, unsigned int height, ImageT
     return RID();
   }
 
-  vk::ImageCreateInfo imageCreateInfo{
-    .imageType    = static_cast<vk::ImageType>(type),
-    .format       = static_cast<vk::Format>(format),
-    .extent       = vk::Extent3D{ width, height, 1 },
-    .mipLevels    = 1,
-    .arrayLayers  = 1,
-    .samples      = vk::SampleCountFlagBits::e1,
-    .tiling       = vk::ImageTiling::eOptimal,
-    .usage        = vk::ImageUsageFlagBits::eStorage,
-  };
-
-  vk::Image image = m_allocator->allocateImage(imageCreateInfo);
-
-  std::vector<vk::CommandBuffer> cmds = m_context->transferCmds(1);
-  vk::CommandBuffer& cmd = cmds[0];
-  cmd.begin(vk::CommandBufferBeginInfo{ .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
-
-  vk::ImageMemoryBarrier shaderBarrier{
-    .oldLayout        = vk::ImageLayout::eUndefined,
-    .newLayout        = vk::ImageLayout::eGeneral,
-    .image            = image,
-    .subresourceRange = {
-      .aspectMask = vk::ImageAspectFlagBits::eColor,
-      .levelCount = 1,
-      .layerCount = 1
-    }
-  };
-
-  cmd.pipelineBarrier(
-    vk::PipelineStageFlagBits::eTopOfPipe,
-    vk::PipelineStageFlagBits::eTopOfPipe,
-    vk::DependencyFlags(),
-    nullptr,
-    nullptr,
-    shaderBarrier
-  );
-
-  cmd.end();
-
-  vk::Fence fence = m_context->device().createFence({});
-
-  auto [index, queue] = m_context->transferQueue();
-  queue.submit(vk::SubmitInfo{
-    .commandBufferCount = 1,
-    .pCommandBuffers    = &cmd,
-  }, fence);
-
-  vk::ImageViewCreateInfo viewCreateInfo{
-    .image    = image,
-    .viewType = static_cast<vk::ImageViewType>(type),
-    .format   = static_cast<vk::Format>(format),
-    .components = {
-      .r = vk::ComponentSwizzle::eIdentity,
-      .g = vk::ComponentSwizzle::eIdentity,
-      .b = vk::ComponentSwizzle::eIdentity,
-      .a = vk::ComponentSwizzle::eIdentity
-    },
-    .subresourceRange = {
-      .aspectMask = vk::ImageAspectFlagBits::eColor,
-      .levelCount = 1,
-      .layerCount = 1
-    }
-  };
-
-  vk::ImageView view = m_context->device().createImageView(viewCreateInfo);
-
-  ImageHandle * handle = new ImageHandle;
-  handle->image = image;
-  handle->view = view;
-
-  RID rid(m_nextRID++, ResourceType::StorageImage);
-  m_resources[rid] = reinterpret_cast<unsigned long>(handle);
-
-  if (m_context->device().waitForFences(fence, true, 1000000000) != vk::Result::eSuccess)
-    Log::runtime_error("Hung waiting for storage image transition");
-
-  m_context->device().destroyFence(fence);
-  m_context->destroyTransferCmds(cmds);
+  if (!validImageDimensions(width, height, depth, type)) return RID();
 
-  return rid;
+  return createStorageImage(width, height, depth, type, format, RID());
 }
 
 RID Engine::create_texture(const std::string& path, const RID& sampler) {
@@ -478,132 +529,161 @@ RID Engine::create_texture(const std::string& path, const RID& sampler) {
     Log::warn(std::format("failed to load image: {}", std::string(stbi_failure_reason())));
     return RID();
   }
-  unsigned int size = width * height * 4;
 
-  vk::Buffer buffer = m_allocator->allocateBuffer(vk::BufferCreateInfo{
-    .size   = static_cast<unsigned int>(width * height * 4),
-    .usage  = vk::BufferUsageFlagBits::eTransferSrc
-  });
+  RID rid = createTexture(width, height, 1, pixels, sampler);
+  stbi_image_free(pixels);
 
-  void * map = m_allocator->mapBuffer(buffer);
-  std::memcpy(map, pixels, size);
-  m_allocator->unmapBuffer(buffer);
+  return rid;
+}
 
-  stbi_image_free(pixels);
-  map = pixels = nullptr;
+RID Engine::create_texture_array(const std::vector<std::string>& paths, const RID& sampler) {
+  if (!sampler.is_valid()) {
+    Log::warn("tried to create texture array with invalid sampler RID");
+    return RID();
+  }
 
-  vk::Image image = m_allocator->allocateImage(vk::ImageCreateInfo{
-    .imageType    = vk::ImageType::e2D,
-    .format       = vk::Format::eR8G8B8A8Srgb,
-    .extent       = { static_cast<unsigned int>(width), static_cast<unsigned int>(height), 1 },
-    .mipLevels    = 1,
-    .arrayLayers  = 1,
-    .samples      = vk::SampleCountFlagBits::e1,
-    .tiling       = vk::ImageTiling::eOptimal,
-    .usage        = vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferDst
-  });
+  if (sampler.m_type != ResourceType::Sampler) {
+    Log::warn("tried to create texture array with non-sampler RID");
+    return RID();
+  }
 
-  std::vector<vk::CommandBuffer> cmds = m_context->transferCmds(1);
-  vk::CommandBuffer& cmd = cmds[0];
-  cmd.begin(vk::CommandBufferBeginInfo{ .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+  if (paths.empty()) {
+    Log::warn("tried to create texture array with no images");
+    return RID();
+  }
 
-  vk::ImageMemoryBarrier copyBarrier{
-    .dstAccessMask    = vk::AccessFlagBits::eTransferWrite,
-    .newLayout        = vk::ImageLayout::eTransferDstOptimal,
-    .image            = image,
-    .subresourceRange = {
-      .aspectMask = vk::ImageAspectFlagBits::eColor,
-      .levelCount = 1,
-      .layerCount = 1
+  unsigned int maxLayers = m_context->gpu().getProperties().limits.maxImageArrayLayers;
+  if (paths.size() > maxLayers) {
+    Log::warn(std::format("tried to create texture array with {} layers. GPU supports at most {}", paths.size(), maxLayers));
+    return RID();
+  }
+
+  int width = 0, height = 0;
+  std::vector<unsigned char> pixels;
+
+  for (const auto& path : paths) {
+    int w, h, channels;
+    unsigned char * layer = stbi_load(path.c_str(), &w, &h, &channels, STBI_rgb_alpha);
+    if (!layer) {
+      Log::warn(std::format("failed to load image {}: {}", path, std::string(stbi_failure_reason())));
+      return RID();
     }
-  };
 
-  cmd.pipelineBarrier(
-    vk::PipelineStageFlagBits::eTopOfPipe,
-    vk::PipelineStageFlagBits::eTransfer,
-    vk::DependencyFlags(),
-    nullptr,
-    nullptr,
-    copyBarrier
-  );
+    if (pixels.empty()) {
+      width = w;
+      height = h;
+      pixels.reserve(static_cast<std::size_t>(width) * height * 4 * paths.size());
+    }
 
-  cmd.copyBufferToImage(buffer, image, vk::ImageLayout::eTransferDstOptimal, vk::BufferImageCopy{
-    .imageSubresource = {
-      .aspectMask = vk::ImageAspectFlagBits::eColor,
-      .layerCount = 1
-    },
-    .imageExtent = { static_cast<unsigned int>(width), static_cast<unsigned int>(height), 1 }
-  });
+    if (w != width || h != height) {
+      Log::warn(std::format("texture array layer {} is {}x{} but the array is {}x{}", path, w, h, width, height));
+      stbi_image_free(layer);
+      return RID();
+    }
 
-  vk::ImageMemoryBarrier shaderBarrier{
-    .srcAccessMask    = vk::AccessFlagBits::eTransferWrite,
-    .dstAccessMask    = vk::AccessFlagBits::eShaderRead,
-    .oldLayout        = vk::ImageLayout::eTransferDstOptimal,
-    .newLayout        = vk::ImageLayout::eShaderReadOnlyOptimal,
-    .image            = image,
-    .subresourceRange = {
-      .aspectMask = vk::ImageAspectFlagBits::eColor,
-      .levelCount = 1,
-      .layerCount = 1
+    pixels.insert(pixels.end(), layer, layer + static_cast<std::size_t>(w) * h * 4);
+    stbi_image_free(layer);
+  }
+
+  return createTexture(width, height, paths.size(), pixels.data(), sampler);
+}
+
+RID Engine::create_texture_atlas(const std::vector<std::string>& paths, const RID& sampler) {
+  if (!sampler.is_valid()) {
+    Log::warn("tried to create texture atlas with invalid sampler RID");
+    return RID();
+  }
+
+  if (sampler.m_type != ResourceType::Sampler) {
+    Log::warn("tried to create texture atlas with non-sampler RID");
+    return RID();
+  }
+
+  if (paths.empty()) {
+    Log::warn("tried to create texture atlas with no images");
+    return RID();
+  }
+
+  std::vector<std::pair<unsigned int, unsigned int>> sizes;
+  std::vector<unsigned char *> images;
+
+  for (const auto& path : paths) {
+    int w, h, channels;
+    unsigned char * image = stbi_load(path.c_str(), &w, &h, &channels, STBI_rgb_alpha);
+    if (!image) {
+      Log::warn(std::format("failed to load image {}: {}", path, std::string(stbi_failure_reason())));
+      for (auto * loaded : images)
+        stbi_image_free(loaded);
+      return RID();
     }
-  };
 
-  cmd.pipelineBarrier(
-    vk::PipelineStageFlagBits::eTransfer,
-    vk::PipelineStageFlagBits::eFragmentShader,
-    vk::DependencyFlags(),
-    nullptr,
-    nullptr,
-    shaderBarrier
-  );
+    sizes.emplace_back(w, h);
+    images.emplace_back(image);
+  }
 
-  cmd.end();
+  AtlasPacker packer(m_context->gpu().getProperties().limits.maxImageDimension2D);
+  AtlasLayout layout = packer.pack(sizes);
 
-  vk::Fence fence = m_context->device().createFence({});
+  if (layout.width == 0) {
+    Log::warn("images do not fit in a single texture atlas");
+    for (auto * image : images)
+      stbi_image_free(image);
+    return RID();
+  }
 
-  auto [index, queue] = m_context->transferQueue();
-  queue.submit(vk::SubmitInfo{
-    .commandBufferCount = 1,
-    .pCommandBuffers    = &cmd
-  }, fence);
+  std::vector<unsigned char> pixels(static_cast<std::size_t>(layout.width) * layout.height * 4, 0);
+  std::vector<vec4> regions;
+  regions.reserve(images.size());
 
-  vk::ImageView view = m_context->device().createImageView(vk::ImageViewCreateInfo{
-    .image = image,
-    .viewType = vk::ImageViewType::e2D,
-    .format = vk::Format::eR8G8B8A8Srgb,
-    .components = {
-      .r = vk::ComponentSwizzle::eIdentity,
-      .g = vk::ComponentSwizzle::eIdentity,
-      .b = vk::ComponentSwizzle::eIdentity,
-      .a = vk::ComponentSwizzle::eIdentity
-    },
-    .subresourceRange = {
-      .aspectMask = vk::ImageAspectFlagBits::eColor,
-      .levelCount = 1,
-      .layerCount = 1
+  for (std::size_t i = 0; i < images.size(); ++i) {
+    auto [w, h] = sizes[i];
+    auto [x, y] = layout.offsets[i];
+
+    for (unsigned int row = 0; row < h; ++row) {
+      std::memcpy(
+        pixels.data() + (static_cast<std::size_t>(y + row) * layout.width + x) * 4,
+        images[i] + static_cast<std::size_t>(row) * w * 4,
+        static_cast<std::size_t>(w) * 4
+      );
     }
-  });
 
-  ImageHandle * handle = new ImageHandle;
-  handle->image = image;
-  handle->view = view;
-  handle->sampler = sampler;
+    regions.emplace_back(
+      static_cast<float>(x) / layout.width,
+      static_cast<float>(y) / layout.height,
+      static_cast<float>(w) / layout.width,
+      static_cast<float>(h) / layout.height
+    );
 
-  RID rid(m_nextRID++, ResourceType::Texture);
-  m_resources[rid] = reinterpret_cast<unsigned long>(handle);
-  m_busySamplers.emplace(rid);
+    stbi_image_free(images[i]);
+  }
 
-  if (m_context->device().waitForFences(fence, true, 1000000000) != vk::Result::eSuccess)
-    Log::runtime_error("Hung waiting for texture transition");
+  RID rid = createTexture(layout.width, layout.height, 1, pixels.data(), sampler);
+  if (!rid.is_valid()) return rid;
 
-  m_allocator->destroyBuffer(buffer);
-  m_context->device().destroyFence(fence);
-  m_context->destroyTransferCmds(cmds);
+  reinterpret_cast<ImageHandle *>(m_resources.at(rid))->regions = std::move(regions);
 
   return rid;
 }
 
+std::vector<vec4> Engine::atlas_regions(const RID& rid) const {
+  if (!rid.is_valid()) {
+    Log::warn("tried to get atlas regions of invalid RID");
+    return {};
+  }
+
+  if (rid.m_type != ResourceType::Texture) {
+    Log::warn("tried to get atlas regions of non-texture RID");
+    return {};
+  }
+
+  return reinterpret_cast<ImageHandle *>(m_resources.at(rid))->regions;
+}
+
 RID Engine::create_storage_texture(unsigned int width, unsigned int height, const RID& sampler, ImageType type, Format format) {
+  return create_storage_texture(width, height, defaultLayers(type), sampler, type, format);
+}
+
+RID Engine::create_storage_texture(unsigned int width, unsigned int height, unsigned int depth, const RID& sampler, ImageType type, Format format) {
   if (!sampler.is_valid()) {
     Log::warn("tried to create storage texture with invalid sampler RID");
     return RID();
@@ -619,40 +699,114 @@ RID Engine::create_storage_texture(unsigned int width, unsigned int height, cons
     return RID();
   }
 
-  vk::ImageCreateInfo imageCreateInfo{
-    .imageType    = static_cast<vk::ImageType>(type),
-    .format       = static_cast<vk::Format>(format),
-    .extent       = vk::Extent3D{ width, height, 1 },
-    .mipLevels    = 1,
-    .arrayLayers  = 1,
-    .samples      = vk::SampleCountFlagBits::e1,
-    .tiling       = vk::ImageTiling::eOptimal,
-    .usage        = vk::ImageUsageFlagBits::eStorage | vk::ImageUsageFlagBits::eSampled,
-  };
+  if (width == 0 || height == 0) {
+    Log::warn("tried to create storage texture with 0 in a dimension");
+    return RID();
+  }
 
-  vk::Image image = m_allocator->allocateImage(imageCreateInfo);
+  if (!validImageDimensions(width, height, depth, type)) return RID();
+
+  return createStorageImage(width, height, depth, type, format, sampler);
+}
+
+void Engine::destroy_image(RID& rid) {
+  if (!rid.is_valid()) {
+    Log::warn("tried to destroy invalid image RID");
+    return;
+  }
+
+  if (rid.m_type != ResourceType::StorageImage && rid.m_type != ResourceType::StorageTexture && rid.m_type != ResourceType::Texture) {
+    Log::warn("tried to destroy image of non-image RID");
+    return;
+  }
+
+  releaseBindless(rid);
+
+  ImageHandle * image = reinterpret_cast<ImageHandle *>(m_resources.at(rid));
+
+  m_context->device().destroyImageView(image->view);
+  m_allocator->destroyImage(image->image);
+  if (image->sampler.is_valid())
+    m_busySamplers.erase(m_busySamplers.find(image->sampler));
+
+  if (rid.m_type == ResourceType::StorageTexture)
+    m_storageTextures.erase(reinterpret_cast<unsigned long>(static_cast<VkImage>(image->image)));
+  m_resources.erase(rid);
+  delete image;
+
+  rid.invalidate();
+}
+
+std::future<std::vector<unsigned char>> Engine::read_image_async(const RID& rid, const ImageRegion& region) {
+  if (!rid.is_valid()) {
+    Log::warn("tried to read from invalid image RID");
+    return {};
+  }
+
+  if (
+    rid.m_type != ResourceType::StorageImage &&
+    rid.m_type != ResourceType::StorageTexture &&
+    rid.m_type != ResourceType::Texture &&
+    rid.m_type != ResourceType::RenderTarget
+  ) {
+    Log::warn("tried to read image from non-image RID");
+    return {};
+  }
+
+  const vk::CommandBuffer * frameCmd = m_renderer->recordingCmd();
+
+  if (rid.m_type == ResourceType::RenderTarget && (frameCmd == nullptr || m_renderer->preDraw())) {
+    Log::warn("the render target can only be read back during post draw");
+    return {};
+  }
+
+  ImageHandle * handle = rid.m_type == ResourceType::RenderTarget
+    ? m_renderTarget
+    : reinterpret_cast<ImageHandle *>(m_resources.at(rid));
+
+  bool volume = handle->extent.depth > 1;
+  unsigned int width = region.width == 0 ? handle->extent.width - std::min(region.x, handle->extent.width) : region.width;
+  unsigned int height = region.height == 0 ? handle->extent.height - std::min(region.y, handle->extent.height) : region.height;
+  unsigned int depth = region.depth == 0 ? handle->extent.depth - std::min(region.z, handle->extent.depth) : region.depth;
+
+  if (
+    width == 0 || height == 0 || depth == 0 ||
+    region.x + width > handle->extent.width ||
+    region.y + height > handle->extent.height ||
+    region.z + depth > handle->extent.depth ||
+    region.layer >= handle->layers
+  ) {
+    Log::warn("tried to read image region outside of the image");
+    return {};
+  }
+
+  std::size_t size = static_cast<std::size_t>(width) * height * depth * vk::blockSize(handle->format);
+
+  vk::BufferImageCopy copy{
+    .imageSubresource = {
+      .aspectMask     = vk::ImageAspectFlagBits::eColor,
+      .baseArrayLayer = region.layer,
+      .layerCount     = 1
+    },
+    .imageOffset = { static_cast<int>(region.x), static_cast<int>(region.y), static_cast<int>(volume ? region.z : 0) },
+    .imageExtent = { width, height, depth }
+  };
+
+  vk::ImageLayout layout = vk::ImageLayout::eShaderReadOnlyOptimal;
+  if (rid.m_type == ResourceType::StorageImage || rid.m_type == ResourceType::RenderTarget)
+    layout = vk::ImageLayout::eGeneral;
+  else if (rid.m_type == ResourceType::StorageTexture && frameCmd != nullptr && m_renderer->preDraw())
+    layout = vk::ImageLayout::eGeneral;
+
+  if (frameCmd != nullptr)
+    return m_readbacks->record(m_allocator, *frameCmd, m_renderer->frameIndex(), handle->image, layout, copy, size);
 
   std::vector<vk::CommandBuffer> cmds = m_context->transferCmds(1);
   vk::CommandBuffer& cmd = cmds[0];
   cmd.begin(vk::CommandBufferBeginInfo{ .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
 
-  vk::ImageMemoryBarrier shaderBarrier{
-    .newLayout        = vk::ImageLayout::eShaderReadOnlyOptimal,
-    .image            = image,
-    .subresourceRange = {
-      .aspectMask = vk::ImageAspectFlagBits::eColor,
-      .levelCount = 1,
-      .layerCount = 1
-    }
-  };
-
-  cmd.pipelineBarrier(
-    vk::PipelineStageFlagBits::eTopOfPipe,
-    vk::PipelineStageFlagBits::eTopOfPipe,
-    vk::DependencyFlags(),
-    nullptr,
-    nullptr,
-    shaderBarrier
+  std::future<std::vector<unsigned char>> future = m_readbacks->record(
+    m_allocator, cmd, m_readbacks->immediateSlot(), handle->image, layout, copy, size
   );
 
   cmd.end();
@@ -665,87 +819,118 @@ RID Engine::create_storage_texture(unsigned int width, unsigned int height, cons
     .pCommandBuffers    = &cmd
   }, fence);
 
-  vk::ImageViewCreateInfo viewCreateInfo{
-    .image = image,
-    .viewType = static_cast<vk::ImageViewType>(type),
-    .format = static_cast<vk::Format>(format),
-    .components = {
-      .r = vk::ComponentSwizzle::eIdentity,
-      .g = vk::ComponentSwizzle::eIdentity,
-      .b = vk::ComponentSwizzle::eIdentity,
-      .a = vk::ComponentSwizzle::eIdentity
-    },
-    .subresourceRange = {
-      .aspectMask = vk::ImageAspectFlagBits::eColor,
-      .levelCount = 1,
-      .layerCount = 1
-    }
-  };
-
-  vk::ImageView view = m_context->device().createImageView(viewCreateInfo);
-
-  ImageHandle * handle = new ImageHandle;
-  handle->image = image;
-  handle->view = view;
-  handle->sampler = sampler;
-
-  RID rid(m_nextRID++, ResourceType::StorageTexture);
-  m_resources[rid] = reinterpret_cast<unsigned long>(handle);
-  m_busySamplers.emplace(sampler);
-  m_storageTextures.emplace(reinterpret_cast<unsigned long>(static_cast<VkImage>(image)));
-
   if (m_context->device().waitForFences(fence, true, 1000000000) != vk::Result::eSuccess)
-    Log::runtime_error("Hung waiting for storage texture transition");
+    Log::runtime_error("Hung waiting for image readback");
+
+  m_readbacks->resolve(m_allocator, m_readbacks->immediateSlot());
 
   m_context->device().destroyFence(fence);
   m_context->destroyTransferCmds(cmds);
 
-  return rid;
+  return future;
 }
 
-void Engine::destroy_image(RID& rid) {
-  if (!rid.is_valid()) {
-    Log::warn("tried to destroy invalid image RID");
-    return;
+RID Engine::compile_shader(ShaderType type, const std::string& path, const std::vector<ShaderDefine>& defines) {
+#ifndef GROOT_SHADER_COMPILER
+  Log::warn(std::format("cannot compile {}. groot was built without runtime shader compilation, use load_shader_spirv instead", path));
+  return RID();
+#else
+  std::string source = m_compiler->readSource(path);
+  if (source.empty()) return RID();
+
+  PreprocessedShader preprocessed = m_compiler->preprocess(type, path, source, defines);
+  if (preprocessed.source.empty()) return RID();
+
+  unsigned long key = m_compiler->cacheKey(type, preprocessed.source);
+  if (auto it = m_shaderCache.find(key); it != m_shaderCache.end()) {
+    ++m_refCounts.at(it->second);
+    return it->second;
   }
 
-  if (rid.m_type != ResourceType::StorageImage && rid.m_type != ResourceType::StorageTexture && rid.m_type != ResourceType::Texture) {
-    Log::warn("tried to destroy image of non-image RID");
-    return;
+  return createShader(
+    type, path, defines, preprocessed.includes, key,
+    m_compiler->compileShader(type, path, preprocessed.source, key), false
+  );
+#endif
+}
+
+std::vector<RID> Engine::compile_shaders(std::span<const ShaderDesc> descs) {
+#ifndef GROOT_SHADER_COMPILER
+  Log::warn("cannot compile shaders. groot was built without runtime shader compilation, use load_shader_spirv instead");
+  return std::vector<RID>(descs.size());
+#else
+  std::vector<unsigned long> keys(descs.size(), 0);
+  std::vector<std::vector<std::string>> includes(descs.size());
+  std::unordered_map<unsigned long, std::shared_future<std::vector<unsigned int>>> compiles;
+
+  for (unsigned int i = 0; i < descs.size(); ++i) {
+    std::string source = m_compiler->readSource(descs[i].path);
+    if (source.empty()) continue;
+
+    PreprocessedShader preprocessed = m_compiler->preprocess(descs[i].type, descs[i].path, source, descs[i].defines);
+    if (preprocessed.source.empty()) continue;
+
+    keys[i] = m_compiler->cacheKey(descs[i].type, preprocessed.source);
+    includes[i] = std::move(preprocessed.includes);
+    if (m_shaderCache.contains(keys[i]) || compiles.contains(keys[i])) continue;
+
+    compiles.emplace(keys[i], m_workers->submit([this, desc = descs[i], source = std::move(preprocessed.source), key = keys[i]] {
+      return m_compiler->compileShader(desc.type, desc.path, source, key);
+    }).share());
   }
 
-  ImageHandle * image = reinterpret_cast<ImageHandle *>(m_resources.at(rid));
+  std::vector<RID> rids;
+  rids.reserve(descs.size());
 
-  m_context->device().destroyImageView(image->view);
-  m_allocator->destroyImage(image->image);
-  if (image->sampler.is_valid())
-    m_busySamplers.erase(image->sampler);
+  for (unsigned int i = 0; i < descs.size(); ++i) {
+    if (keys[i] == 0) {
+      rids.emplace_back();
+      continue;
+    }
 
-  if (rid.m_type == ResourceType::StorageTexture)
-    m_storageTextures.erase(reinterpret_cast<unsigned long>(static_cast<VkImage>(image->image)));
-  m_resources.erase(rid);
-  delete image;
+    if (auto it = m_shaderCache.find(keys[i]); it != m_shaderCache.end()) {
+      ++m_refCounts.at(it->second);
+      rids.emplace_back(it->second);
+      continue;
+    }
 
-  rid.invalidate();
+    rids.emplace_back(createShader(
+      descs[i].type, descs[i].path, descs[i].defines, includes[i], keys[i],
+      compiles.at(keys[i]).get(), false
+    ));
+  }
+
+  return rids;
+#endif
 }
 
-RID Engine::compile_shader(ShaderType type, const std::string& path) {
-  std::vector<unsigned int> code = m_compiler->compileShader(type, path);
+RID Engine::load_shader_spirv(ShaderType type, const std::string& path) {
+  std::vector<unsigned int> code = readSpirv(path);
   if (code.empty()) return RID();
 
-  vk::ShaderModuleCreateInfo createInfo{
-    .codeSize = code.size() * sizeof(unsigned int),
-    .pCode = code.data()
-  };
+  unsigned long key = spirvKey(type, code);
+  if (auto it = m_shaderCache.find(key); it != m_shaderCache.end()) {
+    ++m_refCounts.at(it->second);
+    return it->second;
+  }
 
-  vk::ShaderModule module = m_context->device().createShaderModule(createInfo);
+  return createShader(type, path, {}, {}, key, code, true);
+}
 
-  Log::generic(std::format("compiled {}", path));
+RID Engine::load_shader_spirv(ShaderType type, std::span<const unsigned int> spirv) {
+  std::vector<unsigned int> code(spirv.begin(), spirv.end());
+  if (code.empty() || code[0] != 0x07230203) {
+    Log::warn("tried to load shader from invalid SPIR-V");
+    return RID();
+  }
 
-  RID rid = RID(m_nextRID++, ResourceType::Shader);
-  m_resources[rid] = reinterpret_cast<unsigned long>(static_cast<VkShaderModule>(module));
+  unsigned long key = spirvKey(type, code);
+  if (auto it = m_shaderCache.find(key); it != m_shaderCache.end()) {
+    ++m_refCounts.at(it->second);
+    return it->second;
+  }
 
-  return rid;
+  return createShader(type, "", {}, {}, key, code, true);
 }
 
 void Engine::destroy_shader(RID& rid) {
@@ -759,38 +944,80 @@ void Engine::destroy_shader(RID& rid) {
     return;
   }
 
-  vk::ShaderModule module = reinterpret_cast<VkShaderModule>(m_resources.at(rid));
-  m_context->device().destroyShaderModule(module);
+  if (m_refCounts.at(rid) > 1) {
+    --m_refCounts.at(rid);
+    rid.invalidate();
+    return;
+  }
+
+  for (const auto& pending : m_pendingPipelines)
+    reinterpret_cast<PipelineHandle *>(m_resources.at(pending))->pending.wait();
+
+  ShaderHandle * shader = reinterpret_cast<ShaderHandle *>(m_resources.at(rid));
+  m_context->device().destroyShaderModule(shader->module);
+  m_shaderCache.erase(shader->key);
+  delete shader;
+
   m_resources.erase(rid);
+  m_refCounts.erase(rid);
 
   rid.invalidate();
 }
 
 RID Engine::create_descriptor_set(const std::vector<RID>& descriptors) {
-  std::vector<vk::DescriptorPoolSize> poolSizes = {};
+  DescriptorWrites described;
+  if (!describeDescriptors(descriptors, described)) return RID();
 
-  std::vector<vk::DescriptorBufferInfo> bufferInfos;
-  bufferInfos.reserve(descriptors.size());
+  auto& [bindings, bufferInfos, imageInfos, writes, targetInfos] = described;
 
-  std::vector<vk::DescriptorImageInfo> imageInfos;
-  imageInfos.reserve(2 * descriptors.size());
+  DescriptorSetHandle * set = new DescriptorSetHandle;
+  set->layout = acquireSetLayout(bindings, set->layoutKey);
+  set->bindings = bindings;
+
+  if (!targetInfos.empty()) {
+    for (unsigned int i = 0; i < m_renderer->imageCount(); ++i) {
+      for (const auto& [info, render] : targetInfos)
+        imageInfos[info].imageView = render ? m_renderer->renderTarget(i).second : m_renderer->drawTarget(i).second;
+
+      DescriptorAllocation& target = set->targets.emplace_back(allocateDescriptors(set));
+      writeDescriptors(target, set, writes);
+    }
+
+    RID rid(m_nextRID++, ResourceType::DescriptorSet);
+    m_resources[rid] = reinterpret_cast<unsigned long>(set);
+
+    return rid;
+  }
+
+  set->allocation = allocateDescriptors(set);
+  set->set = set->allocation.set;
+  set->data.resize(bindings.size() * DescriptorSetHandle::stride);
+
+  for (const auto& write : writes) {
+    unsigned char * data = set->data.data() + write.dstBinding * DescriptorSetHandle::stride;
+    if (write.pBufferInfo)
+      std::memcpy(data, write.pBufferInfo, sizeof(vk::DescriptorBufferInfo));
+    else
+      std::memcpy(data, write.pImageInfo, sizeof(vk::DescriptorImageInfo));
+  }
+
+  writeDescriptors(set->allocation, set, writes);
 
-  std::vector<vk::WriteDescriptorSet> writes;
+  RID rid(m_nextRID++, ResourceType::DescriptorSet);
+  m_resources[rid] = reinterpret_cast<unsigned long>(set);
+
+  return rid;
+}
+
+bool Engine::describeDescriptors(const std::vector<RID>& descriptors, DescriptorWrites& described) const {
+  auto& [bindings, bufferInfos, imageInfos, writes, targetInfos] = described;
+  bufferInfos.reserve(descriptors.size());
+  imageInfos.reserve(2 * descriptors.size());
 
   unsigned int binding = 0;
-  int uniformPoolIndex = -1, storagePoolIndex = -1, imagePoolIndex = -1, texturePoolIndex = -1;
-  std::vector<vk::DescriptorSetLayoutBinding> bindings = {};
   for (const auto& descriptor : descriptors) {
     switch (descriptor.m_type) {
       case UniformBuffer:
-        if (uniformPoolIndex == -1) {
-          uniformPoolIndex = poolSizes.size();
-          poolSizes.emplace_back(vk::DescriptorPoolSize{
-            .type = vk::DescriptorType::eUniformBuffer
-          });
-        }
-        ++poolSizes[uniformPoolIndex].descriptorCount;
-
         bindings.emplace_back(vk::DescriptorSetLayoutBinding{
           .binding          = binding,
           .descriptorType   = vk::DescriptorType::eUniformBuffer,
@@ -813,14 +1040,6 @@ RID Engine::create_descriptor_set(const std::vector<RID>& descriptors) {
 
         break;
       case StorageBuffer:
-        if (storagePoolIndex == -1) {
-          storagePoolIndex = poolSizes.size();
-          poolSizes.emplace_back(vk::DescriptorPoolSize{
-            .type = vk::DescriptorType::eStorageBuffer
-          });
-        }
-        ++poolSizes[storagePoolIndex].descriptorCount;
-
         bindings.emplace_back(vk::DescriptorSetLayoutBinding{
           .binding          = binding,
           .descriptorType   = vk::DescriptorType::eStorageBuffer,
@@ -843,14 +1062,6 @@ RID Engine::create_descriptor_set(const std::vector<RID>& descriptors) {
 
         break;
       case StorageImage: {
-        if (imagePoolIndex == -1) {
-          imagePoolIndex = poolSizes.size();
-          poolSizes.emplace_back(vk::DescriptorPoolSize{
-            .type = vk::DescriptorType::eStorageImage
-          });
-        }
-        ++poolSizes[imagePoolIndex].descriptorCount;
-
         bindings.emplace_back(vk::DescriptorSetLayoutBinding{
           .binding          = binding,
           .descriptorType   = vk::DescriptorType::eStorageImage,
@@ -876,14 +1087,6 @@ RID Engine::create_descriptor_set(const std::vector<RID>& descriptors) {
         break;
       }
       case Texture: {
-        if (texturePoolIndex == -1) {
-          texturePoolIndex = poolSizes.size();
-          poolSizes.emplace_back(vk::DescriptorPoolSize{
-            .type = vk::DescriptorType::eCombinedImageSampler
-          });
-        }
-        ++poolSizes[texturePoolIndex].descriptorCount;
-
         bindings.emplace_back(vk::DescriptorSetLayoutBinding{
           .binding          = binding,
           .descriptorType   = vk::DescriptorType::eCombinedImageSampler,
@@ -910,22 +1113,6 @@ RID Engine::create_descriptor_set(const std::vector<RID>& descriptors) {
         break;
       }
       case StorageTexture: {
-        if (imagePoolIndex == -1) {
-          imagePoolIndex = poolSizes.size();
-          poolSizes.emplace_back(vk::DescriptorPoolSize{
-            .type = vk::DescriptorType::eStorageImage
-          });
-        }
-        ++poolSizes[imagePoolIndex].descriptorCount;
-
-        if (texturePoolIndex == -1) {
-          texturePoolIndex = poolSizes.size();
-          poolSizes.emplace_back(vk::DescriptorPoolSize{
-            .type = vk::DescriptorType::eCombinedImageSampler
-          });
-        }
-        ++poolSizes[texturePoolIndex].descriptorCount;
-
         ImageHandle * image = reinterpret_cast<ImageHandle *>(m_resources.at(descriptor));
 
         bindings.emplace_back(vk::DescriptorSetLayoutBinding{
@@ -972,14 +1159,6 @@ RID Engine::create_descriptor_set(const std::vector<RID>& descriptors) {
         break;
       }
       case RenderTarget: {
-        if (imagePoolIndex == -1) {
-          imagePoolIndex = poolSizes.size();
-          poolSizes.emplace_back(vk::DescriptorPoolSize{
-            .type = vk::DescriptorType::eStorageImage
-          });
-        }
-        poolSizes[imagePoolIndex].descriptorCount += 2;
-
         bindings.emplace_back(vk::DescriptorSetLayoutBinding{
           .binding          = binding,
           .descriptorType   = vk::DescriptorType::eStorageImage,
@@ -987,8 +1166,8 @@ RID Engine::create_descriptor_set(const std::vector<RID>& descriptors) {
           .stageFlags       = vk::ShaderStageFlagBits::eAll
         });
 
+        targetInfos.emplace_back(imageInfos.size(), false);
         imageInfos.emplace_back(vk::DescriptorImageInfo{
-          .imageView    = m_drawOutput->view,
           .imageLayout  = vk::ImageLayout::eGeneral
         });
 
@@ -1007,8 +1186,8 @@ RID Engine::create_descriptor_set(const std::vector<RID>& descriptors) {
           .stageFlags       = vk::ShaderStageFlagBits::eAll
         });
 
+        targetInfos.emplace_back(imageInfos.size(), true);
         imageInfos.emplace_back(vk::DescriptorImageInfo{
-          .imageView    = m_renderTarget->view,
           .imageLayout  = vk::ImageLayout::eGeneral
         });
 
@@ -1024,46 +1203,57 @@ RID Engine::create_descriptor_set(const std::vector<RID>& descriptors) {
       }
       case Invalid:
         Log::warn("invalid RID given as a descriptor");
-        return RID();
+        return false;
       default:
         Log::warn("non-buffer/image/sampler RID given as a descriptor");
-        return RID();
+        return false;
     }
   }
 
-  vk::DescriptorSetLayoutCreateInfo layoutCreateInfo{
-    .bindingCount = static_cast<unsigned int>(bindings.size()),
-    .pBindings    = bindings.data(),
-  };
-
-  DescriptorSetHandle * set = new DescriptorSetHandle;
-  set->layout = m_context->device().createDescriptorSetLayout(layoutCreateInfo);
-
-  vk::DescriptorPoolCreateInfo poolCreateInfo{
-    .maxSets        = 1,
-    .poolSizeCount  = static_cast<unsigned int>(poolSizes.size()),
-    .pPoolSizes     = poolSizes.data(),
-  };
-
-  set->pool = m_context->device().createDescriptorPool(poolCreateInfo);
+  return true;
+}
 
-  vk::DescriptorSetAllocateInfo allocateInfo{
-    .descriptorPool     = set->pool,
-    .descriptorSetCount = 1,
-    .pSetLayouts        = &set->layout
-  };
+DescriptorAllocation Engine::allocateDescriptors(const DescriptorSetHandle * set) {
+  if (m_descriptorBuffer) return m_descriptorBuffer->allocate(m_context, set->layout);
+  return m_descriptors->allocate(m_context->device(), set->layout, set->bindings);
+}
 
-  set->set = m_context->device().allocateDescriptorSets(allocateInfo)[0];
+void Engine::writeDescriptors(const DescriptorAllocation& allocation, const DescriptorSetHandle * set, std::vector<vk::WriteDescriptorSet>& writes) {
+  if (m_descriptorBuffer) {
+    for (const auto& write : writes)
+      m_descriptorBuffer->write(m_context, m_allocator, allocation, set->layout, write);
+    return;
+  }
 
   for (auto& write : writes)
-    write.dstSet = set->set;
+    write.dstSet = allocation.set;
 
   m_context->device().updateDescriptorSets(writes, nullptr);
+}
 
-  RID rid(m_nextRID++, ResourceType::DescriptorSet);
-  m_resources[rid] = reinterpret_cast<unsigned long>(set);
+void Engine::rewriteDescriptors(const DescriptorAllocation& allocation, const DescriptorSetHandle * set) {
+  if (!m_descriptorBuffer) {
+    m_context->device().updateDescriptorSetWithTemplate(allocation.set, set->updateTemplate, set->data.data());
+    return;
+  }
 
-  return rid;
+  for (const auto& binding : set->bindings) {
+    const unsigned char * data = set->data.data() + binding.binding * DescriptorSetHandle::stride;
+    m_descriptorBuffer->write(m_context, m_allocator, allocation, set->layout, vk::WriteDescriptorSet{
+      .dstBinding       = binding.binding,
+      .descriptorCount  = 1,
+      .descriptorType   = binding.descriptorType,
+      .pImageInfo       = reinterpret_cast<const vk::DescriptorImageInfo *>(data),
+      .pBufferInfo      = reinterpret_cast<const vk::DescriptorBufferInfo *>(data)
+    });
+  }
+}
+
+void Engine::freeDescriptors(const DescriptorAllocation& allocation) {
+  if (m_descriptorBuffer)
+    m_descriptorBuffer->free(allocation);
+  else
+    m_descriptors->free(m_context->device(), allocation);
 }
 
 void Engine::destroy_descriptor_set(RID& rid) {
@@ -1077,283 +1267,416 @@ void Engine::destroy_descriptor_set(RID& rid) {
     return;
   }
 
+  if (rid == m_bindlessSet) {
+    Log::warn("tried to destroy the bindless descriptor set");
+    return;
+  }
+
   DescriptorSetHandle * set = reinterpret_cast<DescriptorSetHandle *>(m_resources.at(rid));
-  m_context->device().destroyDescriptorSetLayout(set->layout);
-  m_context->device().destroyDescriptorPool(set->pool);
+  std::vector<DescriptorAllocation> allocations = set->copies;
+  allocations.insert(allocations.end(), set->targets.begin(), set->targets.end());
+  if (allocations.empty()) allocations.emplace_back(set->allocation);
+  deferDeletion([this, allocations, updateTemplate = set->updateTemplate] {
+    for (const auto& allocation : allocations)
+      freeDescriptors(allocation);
+    if (updateTemplate) m_context->device().destroyDescriptorUpdateTemplate(updateTemplate);
+  });
+
+  releaseSetLayout(set->layoutKey);
   delete set;
 
+  m_staleSets.erase(rid);
   m_resources.erase(rid);
 
   rid.invalidate();
 }
 
-RID Engine::create_compute_pipeline(const RID& shader, const RID& descriptorSet) {
-  if (!shader.is_valid()) {
-    Log::warn("tried to make compute pipeline with invalid RID");
-    return RID();
+void Engine::update_descriptor_set(const RID& rid, unsigned int binding, const RID& descriptor) {
+  if (!rid.is_valid()) {
+    Log::warn("tried to update descriptor set of invalid RID");
+    return;
   }
 
-  if (shader.m_type != ResourceType::Shader) {
-    Log::warn("tried to make compute pipeline with non-shader RID");
-    return RID();
+  if (rid.m_type != ResourceType::DescriptorSet) {
+    Log::warn("tried to update descriptor set of non-descriptor-set RID");
+    return;
   }
 
-  if (!descriptorSet.is_valid()) {
-    Log::warn("tried to make compute pipeline with invalid descriptor set");
-    return RID();
+  if (rid == m_bindlessSet) {
+    Log::warn("tried to update the bindless descriptor set");
+    return;
   }
 
-  if (descriptorSet.m_type != ResourceType::DescriptorSet) {
-    Log::warn("tried to make compute pipeline with non-descriptor-set RID");
-    return RID();
+  if (!descriptor.is_valid()) {
+    Log::warn("tried to update descriptor set with invalid descriptor RID");
+    return;
   }
 
-  vk::PipelineShaderStageCreateInfo shaderStage{
-    .stage  = vk::ShaderStageFlagBits::eCompute,
-    .module = reinterpret_cast<VkShaderModule>(m_resources.at(shader)),
-    .pName  = "main"
-  };
-
-  DescriptorSetHandle * set = reinterpret_cast<DescriptorSetHandle *>(m_resources.at(descriptorSet));
+  DescriptorSetHandle * set = reinterpret_cast<DescriptorSetHandle *>(m_resources.at(rid));
+  if (!set->targets.empty()) {
+    Log::warn("tried to update a descriptor set that holds the render target");
+    return;
+  }
 
-  vk::PushConstantRange pushConstants{
-    .stageFlags = vk::ShaderStageFlagBits::eCompute,
-    .size = m_context->gpu().getProperties().limits.maxPushConstantsSize
-  };
+  if (binding >= set->bindings.size()) {
+    Log::warn(std::format("tried to update binding {} of a descriptor set with {} bindings", binding, set->bindings.size()));
+    return;
+  }
 
-  vk::PipelineLayoutCreateInfo layoutCreateInfo{
-    .setLayoutCount         = 1,
-    .pSetLayouts            = &set->layout,
-    .pushConstantRangeCount = 1,
-    .pPushConstantRanges    = &pushConstants
-  };
+  unsigned char * data = set->data.data() + binding * DescriptorSetHandle::stride;
+  vk::DescriptorType type = set->bindings[binding].descriptorType;
+  bool image = descriptor.m_type == ResourceType::StorageImage || descriptor.m_type == ResourceType::StorageTexture || descriptor.m_type == ResourceType::Texture;
+
+  if (
+    (type == vk::DescriptorType::eUniformBuffer && descriptor.m_type == ResourceType::UniformBuffer) ||
+    (type == vk::DescriptorType::eStorageBuffer && descriptor.m_type == ResourceType::StorageBuffer)
+  ) {
+    vk::DescriptorBufferInfo info{
+      .buffer = reinterpret_cast<VkBuffer>(m_resources.at(descriptor)),
+      .range  = vk::WholeSize
+    };
+    std::memcpy(data, &info, sizeof(info));
+  }
+  else if (type == vk::DescriptorType::eStorageImage && image && descriptor.m_type != ResourceType::Texture) {
+    vk::DescriptorImageInfo info{
+      .imageView    = reinterpret_cast<ImageHandle *>(m_resources.at(descriptor))->view,
+      .imageLayout  = vk::ImageLayout::eGeneral
+    };
+    std::memcpy(data, &info, sizeof(info));
+  }
+  else if (type == vk::DescriptorType::eCombinedImageSampler && image && descriptor.m_type != ResourceType::StorageImage) {
+    ImageHandle * handle = reinterpret_cast<ImageHandle *>(m_resources.at(descriptor));
+    vk::DescriptorImageInfo info{
+      .sampler      = reinterpret_cast<VkSampler>(m_resources.at(handle->sampler)),
+      .imageView    = handle->view,
+      .imageLayout  = vk::ImageLayout::eShaderReadOnlyOptimal
+    };
+    std::memcpy(data, &info, sizeof(info));
+  }
+  else {
+    Log::warn(std::format("descriptor does not match the {} at binding {}", vk::to_string(type), binding));
+    return;
+  }
 
-  PipelineHandle * pipeline = new PipelineHandle;
-  pipeline->layout = m_context->device().createPipelineLayout(layoutCreateInfo);
+  if (!m_descriptorBuffer && !set->updateTemplate) {
+    std::vector<vk::DescriptorUpdateTemplateEntry> entries;
+    for (const auto& layoutBinding : set->bindings) {
+      entries.emplace_back(vk::DescriptorUpdateTemplateEntry{
+        .dstBinding       = layoutBinding.binding,
+        .descriptorCount  = 1,
+        .descriptorType   = layoutBinding.descriptorType,
+        .offset           = layoutBinding.binding * DescriptorSetHandle::stride,
+        .stride           = DescriptorSetHandle::stride
+      });
+    }
 
-  vk::ComputePipelineCreateInfo pipelineCreateInfo{
-    .stage  = shaderStage,
-    .layout = pipeline->layout
-  };
+    set->updateTemplate = m_context->device().createDescriptorUpdateTemplate(vk::DescriptorUpdateTemplateCreateInfo{
+      .descriptorUpdateEntryCount = static_cast<unsigned int>(entries.size()),
+      .pDescriptorUpdateEntries   = entries.data(),
+      .templateType               = vk::DescriptorUpdateTemplateType::eDescriptorSet,
+      .descriptorSetLayout        = set->layout
+    });
+  }
 
-  vk::ResultValue<vk::Pipeline> result = m_context->device().createComputePipeline(nullptr, pipelineCreateInfo);
-  if (!result.has_value()) {
-    Log::warn("failed to create compute pipeline");
+  if (set->copies.empty()) {
+    deferDeletion([this, allocation = set->allocation] { freeDescriptors(allocation); });
 
-    m_context->device().destroyPipelineLayout(pipeline->layout);
-    delete pipeline;
+    for (unsigned int i = 0; i < m_settings.flight_frames; ++i)
+      rewriteDescriptors(set->copies.emplace_back(allocateDescriptors(set)), set);
 
-    return RID();
+    set->set = nullptr;
+    return;
   }
 
-  pipeline->pipeline = result.value;
+  set->stale = (1u << set->copies.size()) - 1;
+  m_staleSets.emplace(rid);
+}
 
-  RID rid(m_nextRID++, ResourceType::Pipeline);
-  m_resources[rid] = reinterpret_cast<unsigned long>(pipeline);
+unsigned int Engine::descriptor_pools() const {
+  return m_descriptors->poolCount();
+}
 
-  return rid;
+RID Engine::bindless_set() const {
+  if (!m_bindless) Log::warn("tried to get the bindless descriptor set without bindless descriptors enabled");
+  return m_bindlessSet;
 }
 
-RID Engine::create_graphics_pipeline(const GraphicsPipelineShaders& shaders, const RID& descriptorSet, const GraphicsPipelineSettings& s) {
-  if (!shaders.vertex.is_valid()) {
-    Log::warn("invalid vertex shader RID");
-    return {};
+unsigned int Engine::bindless_index(const RID& rid) const {
+  if (!rid.is_valid()) {
+    Log::warn("tried to get bindless index of invalid RID");
+    return 0;
   }
 
-  if (shaders.vertex.m_type != ResourceType::Shader) {
-    Log::warn("vertex RID is not a shader RID");
-    return {};
+  auto it = m_bindlessIndices.find(rid);
+  if (it == m_bindlessIndices.end()) {
+    Log::warn("tried to get bindless index of a resource that is not in the bindless descriptor set");
+    return 0;
   }
 
-  if (!shaders.fragment.is_valid()) {
-    Log::warn("invalid fragment shader RID");
-    return {};
-  }
+  return it->second;
+}
 
-  if (shaders.fragment.m_type != ResourceType::Shader) {
-    Log::warn("fragment RID is not a shader RID");
-    return {};
+RID Engine::create_compute_pipeline(const RID& shader, const RID& descriptorSet, const SpecializationConstants& constants) {
+  PipelineHandle * pipeline = prepareComputePipeline(shader, descriptorSet, constants);
+  if (!pipeline) return RID();
+
+  return registerPipeline(pipeline, false);
+}
+
+RID Engine::create_compute_pipeline_async(const RID& shader, const RID& descriptorSet, const SpecializationConstants& constants, const RID& fallback) {
+  PipelineHandle * pipeline = prepareComputePipeline(shader, descriptorSet, constants);
+  if (!pipeline) return RID();
+
+  if (validateFallback(fallback, pipeline))
+    pipeline->fallback = fallback;
+
+  return registerPipeline(pipeline, true);
+}
+
+RID Engine::create_push_compute_pipeline(const RID& shader, const SpecializationConstants& constants) {
+  if (!shader.is_valid()) {
+    Log::warn("tried to make push descriptor compute pipeline with invalid RID");
+    return RID();
   }
 
-  if (shaders.tesselation_control.is_valid() && !shaders.tesselation_evaluation.is_valid()) {
-    Log::warn("found valid tesselation control shader RID but invalid tesselation evaluation shader RID");
-    return {};
+  if (shader.m_type != ResourceType::Shader) {
+    Log::warn("tried to make push descriptor compute pipeline with non-shader RID");
+    return RID();
   }
 
-  if (shaders.tesselation_control.is_valid() && shaders.tesselation_control.m_type != ResourceType::Shader) {
-    Log::warn("tesselation control RID is not a shader RID");
-    return {};
+  if (!m_context->supportsPushDescriptors()) {
+    Log::warn("GPU does not support push descriptors. use create_compute_pipeline with a descriptor set instead");
+    return RID();
   }
 
-  if (shaders.tesselation_evaluation.is_valid() && shaders.tesselation_evaluation.m_type != ResourceType::Shader) {
-    Log::warn("tesselation evaluation RID is not a shader RID");
-    return {};
+  PipelineHandle * pipeline = new PipelineHandle;
+  pipeline->bindPoint = vk::PipelineBindPoint::eCompute;
+  pipeline->compute = shader;
+  pipeline->specialization = constants;
+  pipeline->pushDescriptors = true;
+
+  if (!reflectPipeline(pipeline, pipeline->reflection)) {
+    Log::warn("failed to reflect push descriptor compute shader");
+    delete pipeline;
+    return RID();
   }
 
-  if ((shaders.tesselation_control.is_valid() || shaders.tesselation_evaluation.is_valid()) && !m_context->supportsTesselation()) {
-    Log::warn("tesselation shaders are not supported on this GPU and will be skipped during pipeline creation");
+  std::vector<vk::DescriptorSetLayoutBinding> bindings;
+  for (const auto& reflected : pipeline->reflection.bindings) {
+    if (reflected.set != 0) {
+      Log::warn(std::format("push descriptor compute shaders can only use descriptor set 0 but the shader uses set {}", reflected.set));
+      delete pipeline;
+      return RID();
+    }
+
+    bindings.emplace_back(vk::DescriptorSetLayoutBinding{
+      .binding          = reflected.binding,
+      .descriptorType   = reflected.type,
+      .descriptorCount  = reflected.count,
+      .stageFlags       = vk::ShaderStageFlagBits::eAll
+    });
   }
 
-  if (!descriptorSet.is_valid()) {
-    Log::warn("tried to create graphics pipeline with invalid descriptor set RID");
+  if (bindings.size() > m_context->maxPushDescriptors()) {
+    Log::warn(std::format(
+      "push descriptor compute shader uses {} bindings but the GPU can push at most {}",
+      bindings.size(), m_context->maxPushDescriptors()
+    ));
+    delete pipeline;
     return RID();
   }
 
-  if (descriptorSet.m_type != ResourceType::DescriptorSet) {
-    Log::warn("tried to create graphics pipeline with non-descriptor-set RID");
+  if (!validateSpecialization(constants, pipeline->reflection)) {
+    Log::warn("invalid specialization constants for compute pipeline");
+    delete pipeline;
     return RID();
   }
 
-  std::unordered_map<vk::ShaderStageFlagBits, vk::ShaderModule> modules;
-  modules.emplace(vk::ShaderStageFlagBits::eVertex, reinterpret_cast<VkShaderModule>(m_resources.at(shaders.vertex)));
-  modules.emplace(vk::ShaderStageFlagBits::eFragment, reinterpret_cast<VkShaderModule>(m_resources.at(shaders.fragment)));
+  std::sort(bindings.begin(), bindings.end(), [](const auto& lhs, const auto& rhs) { return lhs.binding < rhs.binding; });
+  pipeline->bindings = { bindings };
 
-  if (shaders.tesselation_control.is_valid() && m_context->supportsTesselation())
-    modules.emplace(vk::ShaderStageFlagBits::eTessellationControl, reinterpret_cast<VkShaderModule>(m_resources.at(shaders.tesselation_evaluation)));
+  vk::DescriptorSetLayout setLayout = acquireSetLayout(bindings, pipeline->setLayoutKeys.emplace_back(), true);
+  pipeline->layout = acquirePipelineLayout({ setLayout }, pipeline->setLayoutKeys, pipeline->reflection, pipeline->pushConstants, pipeline->layoutKey);
 
-  if (shaders.tesselation_control.is_valid() && m_context->supportsTesselation())
-    modules.emplace(vk::ShaderStageFlagBits::eTessellationEvaluation, reinterpret_cast<VkShaderModule>(m_resources.at(shaders.tesselation_evaluation)));
+  return registerPipeline(pipeline, false);
+}
 
-  std::vector<vk::PipelineShaderStageCreateInfo> stages = {};
-  for (const auto& [stage, module] : modules) {
-    stages.emplace_back(vk::PipelineShaderStageCreateInfo{
-      .stage  = stage,
-      .module = module,
-      .pName  = "main"
-    });
+PipelineHandle * Engine::prepareComputePipeline(const RID& shader, const RID& descriptorSet, const SpecializationConstants& constants) {
+  if (!shader.is_valid()) {
+    Log::warn("tried to make compute pipeline with invalid RID");
+    return nullptr;
   }
 
-  DescriptorSetHandle * set = reinterpret_cast<DescriptorSetHandle *>(m_resources.at(descriptorSet));
+  if (shader.m_type != ResourceType::Shader) {
+    Log::warn("tried to make compute pipeline with non-shader RID");
+    return nullptr;
+  }
 
-  vk::PushConstantRange pushConstants{
-    .stageFlags = vk::ShaderStageFlagBits::eAll,
-    .size = m_context->gpu().getProperties().limits.maxPushConstantsSize
-  };
+  if (!descriptorSet.is_valid()) {
+    Log::warn("tried to make compute pipeline with invalid descriptor set");
+    return nullptr;
+  }
 
-  vk::PipelineLayoutCreateInfo layoutCreateInfo{
-    .setLayoutCount         = 1,
-    .pSetLayouts            = &set->layout,
-    .pushConstantRangeCount = 1,
-    .pPushConstantRanges    = &pushConstants
-  };
+  if (descriptorSet.m_type != ResourceType::DescriptorSet) {
+    Log::warn("tried to make compute pipeline with non-descriptor-set RID");
+    return nullptr;
+  }
+
+  DescriptorSetHandle * set = reinterpret_cast<DescriptorSetHandle *>(m_resources.at(descriptorSet));
 
   PipelineHandle * pipeline = new PipelineHandle;
-  pipeline->layout = m_context->device().createPipelineLayout(layoutCreateInfo);
+  pipeline->bindPoint = vk::PipelineBindPoint::eCompute;
+  pipeline->compute = shader;
+  pipeline->specialization = constants;
+  pipeline->bindings = { set->bindings };
 
-  std::array<vk::DynamicState, 2> dynamicStates = {
-    vk::DynamicState::eViewport,
-    vk::DynamicState::eScissor
-  };
+  if (!reflectPipeline(pipeline, pipeline->reflection) || !validateBindings(pipeline->bindings, pipeline->reflection)) {
+    Log::warn("compute shader does not match the descriptor set layout");
+    delete pipeline;
+    return nullptr;
+  }
 
-  vk::PipelineDynamicStateCreateInfo dynamicStateCreateInfo{
-    .dynamicStateCount  = 2,
-    .pDynamicStates     = dynamicStates.data()
-  };
+  if (!validateSpecialization(constants, pipeline->reflection)) {
+    Log::warn("invalid specialization constants for compute pipeline");
+    delete pipeline;
+    return nullptr;
+  }
 
-  vk::PipelineViewportStateCreateInfo viewportStateCreateInfo{
-    .viewportCount  = 1,
-    .scissorCount   = 1
-  };
+  pipeline->setLayoutKeys = { set->layoutKey };
+  retainSetLayout(set->layoutKey);
+  pipeline->layout = acquirePipelineLayout({ set->layout }, pipeline->setLayoutKeys, pipeline->reflection, pipeline->pushConstants, pipeline->layoutKey);
 
-  auto binding = Vertex::binding();
-  auto attributes = Vertex::attributes();
-  vk::PipelineVertexInputStateCreateInfo vertexInputCreateInfo{
-    .vertexBindingDescriptionCount    = 1,
-    .pVertexBindingDescriptions       = &binding,
-    .vertexAttributeDescriptionCount  = static_cast<unsigned int>(attributes.size()),
-    .pVertexAttributeDescriptions     = attributes.data()
-  };
+  return pipeline;
+}
 
-  vk::PipelineInputAssemblyStateCreateInfo assemblyCreateInfo{
-    .topology               = vk::PrimitiveTopology::eTriangleList,
-    .primitiveRestartEnable = false
-  };
+RID Engine::create_graphics_pipeline(const GraphicsPipelineShaders& shaders, const RID& descriptorSet, const GraphicsPipelineSettings& s) {
+  return create_graphics_pipeline(shaders, std::vector<RID>{ descriptorSet }, s);
+}
 
-  vk::PolygonMode polygonMode = static_cast<vk::PolygonMode>(s.mesh_type);
-  if (s.mesh_type != MeshType::Solid && !m_context->supportsNonSolidMesh()) {
-    Log::warn("setting pipeline mesh type to solid. GPU does not support non solid meshes");
-    polygonMode = vk::PolygonMode::eFill;
+RID Engine::create_graphics_pipeline(const GraphicsPipelineShaders& shaders, const std::vector<RID>& descriptorSets, const GraphicsPipelineSettings& s) {
+  PipelineHandle * pipeline = prepareGraphicsPipeline(shaders, descriptorSets, s);
+  if (!pipeline) return RID();
+
+  return registerPipeline(pipeline, false);
+}
+
+RID Engine::create_graphics_pipeline_async(const GraphicsPipelineShaders& shaders, const RID& descriptorSet, const GraphicsPipelineSettings& s, const RID& fallback) {
+  return create_graphics_pipeline_async(shaders, std::vector<RID>{ descriptorSet }, s, fallback);
+}
+
+RID Engine::create_graphics_pipeline_async(const GraphicsPipelineShaders& shaders, const std::vector<RID>& descriptorSets, const GraphicsPipelineSettings& s, const RID& fallback) {
+  PipelineHandle * pipeline = prepareGraphicsPipeline(shaders, descriptorSets, s);
+  if (!pipeline) return RID();
+
+  if (validateFallback(fallback, pipeline))
+    pipeline->fallback = fallback;
+
+  return registerPipeline(pipeline, true);
+}
+
+PipelineHandle * Engine::prepareGraphicsPipeline(const GraphicsPipelineShaders& shaders, const std::vector<RID>& descriptorSets, const GraphicsPipelineSettings& s) {
+  if (!shaders.vertex.is_valid()) {
+    Log::warn("invalid vertex shader RID");
+    return nullptr;
   }
 
-  vk::PipelineRasterizationStateCreateInfo rasterizerCreateInfo{
-    .depthClampEnable         = false,
-    .rasterizerDiscardEnable  = false,
-    .polygonMode              = polygonMode,
-    .cullMode                 = static_cast<vk::CullModeFlagBits>(s.cull_mode),
-    .frontFace                = static_cast<vk::FrontFace>(s.draw_direction),
-    .depthBiasEnable          = false,
-    .lineWidth                = 1.0f
-  };
+  if (shaders.vertex.m_type != ResourceType::Shader) {
+    Log::warn("vertex RID is not a shader RID");
+    return nullptr;
+  }
 
-  vk::PipelineMultisampleStateCreateInfo multisampleCreateInfo{
-    .rasterizationSamples = vk::SampleCountFlagBits::e1,
-    .sampleShadingEnable  = false
-  };
+  if (!shaders.fragment.is_valid()) {
+    Log::warn("invalid fragment shader RID");
+    return nullptr;
+  }
 
-  vk::PipelineDepthStencilStateCreateInfo depthCreateInfo{
-    .depthTestEnable        = s.enable_depth_test,
-    .depthWriteEnable       = s.enable_depth_write,
-    .depthCompareOp         = vk::CompareOp::eLess,
-    .depthBoundsTestEnable  = false,
-    .stencilTestEnable      = false
-  };
+  if (shaders.fragment.m_type != ResourceType::Shader) {
+    Log::warn("fragment RID is not a shader RID");
+    return nullptr;
+  }
 
-  vk::PipelineColorBlendAttachmentState colorAttachmentState{
-    .blendEnable          = s.enable_blend,
-    .srcColorBlendFactor  = vk::BlendFactor::eSrcAlpha,
-    .dstColorBlendFactor  = vk::BlendFactor::eOneMinusSrcAlpha,
-    .colorBlendOp         = vk::BlendOp::eAdd,
-    .srcAlphaBlendFactor  = vk::BlendFactor::eOneMinusSrcAlpha,
-    .alphaBlendOp         = vk::BlendOp::eAdd,
-    .colorWriteMask       = vk::ColorComponentFlagBits::eR |
-                            vk::ColorComponentFlagBits::eG |
-                            vk::ColorComponentFlagBits::eB |
-                            vk::ColorComponentFlagBits::eA
-  };
+  if (shaders.tesselation_control.is_valid() && !shaders.tesselation_evaluation.is_valid()) {
+    Log::warn("found valid tesselation control shader RID but invalid tesselation evaluation shader RID");
+    return nullptr;
+  }
 
-  vk::PipelineColorBlendStateCreateInfo blendStateCreateInfo{
-    .logicOpEnable    = false,
-    .attachmentCount  = 1,
-    .pAttachments     = &colorAttachmentState
-  };
+  if (shaders.tesselation_control.is_valid() && shaders.tesselation_control.m_type != ResourceType::Shader) {
+    Log::warn("tesselation control RID is not a shader RID");
+    return nullptr;
+  }
 
-  vk::PipelineRenderingCreateInfo renderingCreateInfo{
-    .colorAttachmentCount     = 1,
-    .pColorAttachmentFormats  = reinterpret_cast<vk::Format *>(&m_settings.color_format),
-    .depthAttachmentFormat    = m_renderer->depthFormat()
-  };
+  if (shaders.tesselation_evaluation.is_valid() && shaders.tesselation_evaluation.m_type != ResourceType::Shader) {
+    Log::warn("tesselation evaluation RID is not a shader RID");
+    return nullptr;
+  }
 
-  vk::GraphicsPipelineCreateInfo pipelineCreateInfo{
-    .pNext                = &renderingCreateInfo,
-    .stageCount           = static_cast<unsigned int>(stages.size()),
-    .pStages              = stages.data(),
-    .pVertexInputState    = &vertexInputCreateInfo,
-    .pInputAssemblyState  = &assemblyCreateInfo,
-    .pViewportState       = &viewportStateCreateInfo,
-    .pRasterizationState  = &rasterizerCreateInfo,
-    .pMultisampleState    = &multisampleCreateInfo,
-    .pDepthStencilState   = &depthCreateInfo,
-    .pColorBlendState     = &blendStateCreateInfo,
-    .pDynamicState        = &dynamicStateCreateInfo,
-    .layout               = pipeline->layout
-  };
+  if ((shaders.tesselation_control.is_valid() || shaders.tesselation_evaluation.is_valid()) && !m_context->supportsTesselation()) {
+    Log::warn("tesselation shaders are not supported on this GPU and will be skipped during pipeline creation");
+  }
 
-  vk::ResultValue<vk::Pipeline> result = m_context->device().createGraphicsPipeline(nullptr, pipelineCreateInfo);
-  if (!result.has_value()) {
-    Log::warn("failed to create graphics pipeline");
+  if (descriptorSets.empty()) {
+    Log::warn("tried to create graphics pipeline without descriptor sets");
+    return nullptr;
+  }
+
+  if (descriptorSets.size() > std::min(m_context->gpu().getProperties().limits.maxBoundDescriptorSets, 4u)) {
+    Log::warn(std::format("tried to create graphics pipeline with {} descriptor sets", descriptorSets.size()));
+    return nullptr;
+  }
+
+  std::vector<vk::DescriptorSetLayout> setLayouts;
+  std::vector<unsigned long> setLayoutKeys;
+  std::vector<std::vector<vk::DescriptorSetLayoutBinding>> bindings;
+  for (const auto& descriptorSet : descriptorSets) {
+    if (!descriptorSet.is_valid()) {
+      Log::warn("tried to create graphics pipeline with invalid descriptor set RID");
+      return nullptr;
+    }
+
+    if (descriptorSet.m_type != ResourceType::DescriptorSet) {
+      Log::warn("tried to create graphics pipeline with non-descriptor-set RID");
+      return nullptr;
+    }
+
+    DescriptorSetHandle * set = reinterpret_cast<DescriptorSetHandle *>(m_resources.at(descriptorSet));
+    if (!set->targets.empty()) {
+      Log::warn("tried to create graphics pipeline with a render target descriptor set. render targets can only be used in post-draw dispatches");
+      return nullptr;
+    }
+
+    setLayouts.emplace_back(set->layout);
+    setLayoutKeys.emplace_back(set->layoutKey);
+    bindings.emplace_back(set->bindings);
+  }
 
-    m_context->device().destroyPipelineLayout(pipeline->layout);
+  PipelineHandle * pipeline = new PipelineHandle;
+  pipeline->bindPoint = vk::PipelineBindPoint::eGraphics;
+  pipeline->shaders = shaders;
+  pipeline->settings = s;
+  pipeline->specialization = s.specialization;
+  pipeline->bindings = std::move(bindings);
+
+  if (!reflectPipeline(pipeline, pipeline->reflection) || !validateBindings(pipeline->bindings, pipeline->reflection)) {
+    Log::warn("graphics shaders do not match the descriptor set layout");
     delete pipeline;
+    return nullptr;
+  }
 
-    return RID();
+  if (!validateSpecialization(s.specialization, pipeline->reflection)) {
+    Log::warn("invalid specialization constants for graphics pipeline");
+    delete pipeline;
+    return nullptr;
   }
 
-  pipeline->pipeline = result.value;
+  pipeline->setLayoutKeys = std::move(setLayoutKeys);
+  for (unsigned long key : pipeline->setLayoutKeys) retainSetLayout(key);
+  pipeline->layout = acquirePipelineLayout(setLayouts, pipeline->setLayoutKeys, pipeline->reflection, pipeline->pushConstants, pipeline->layoutKey);
 
-  RID rid(m_nextRID++, ResourceType::Pipeline);
-  m_resources[rid] = reinterpret_cast<unsigned long>(pipeline);
+  return pipeline;
+}
 
-  return rid;
+unsigned int Engine::pipelines_pending() const {
+  return m_pendingPipelines.size();
 }
 
 void Engine::destroy_pipeline(RID& rid) {
@@ -1367,18 +1690,43 @@ void Engine::destroy_pipeline(RID& rid) {
     return;
   }
 
+  if (m_refCounts.at(rid) > 1) {
+    --m_refCounts.at(rid);
+    rid.invalidate();
+    return;
+  }
+
   PipelineHandle * pipeline = reinterpret_cast<PipelineHandle *>(m_resources.at(rid));
+  if (pipeline->pending.valid()) {
+    pipeline->pipeline = pipeline->pending.get();
+    std::erase(m_pendingPipelines, rid);
+  }
+
+  if (pipeline->optimized.valid()) {
+    m_context->device().destroyPipeline(pipeline->optimized.get());
+    std::erase(m_optimizingPipelines, rid);
+  }
 
-  m_context->device().destroyPipelineLayout(pipeline->layout);
+  releasePipelineLibraries(pipeline);
+  releasePipelineLayout(pipeline->layoutKey);
+  for (unsigned long key : pipeline->setLayoutKeys) releaseSetLayout(key);
   m_context->device().destroyPipeline(pipeline->pipeline);
+  if (auto it = m_pipelineStates.find(pipeline->key); it != m_pipelineStates.end() && it->second == rid)
+    m_pipelineStates.erase(it);
   delete pipeline;
 
   m_resources.erase(rid);
+  m_refCounts.erase(rid);
 
   rid.invalidate();
 }
 
-RID Engine::load_mesh(const std::string& path) {
+RID Engine::load_mesh(const std::string& path, const VertexFormat& format) {
+  if (format.elements.empty() || format.stride == 0) {
+    Log::warn(std::format("tried to load mesh '{}' with an empty vertex format", path));
+    return RID();
+  }
+
   tinyobj::attrib_t attrib;
   std::vector<tinyobj::shape_t> shapes;
   std::string err;
@@ -1495,13 +1843,34 @@ RID Engine::load_mesh(const std::string& path) {
       vertex.normal = vertex.normal.normalized();
   }
 
+  vec3 offset(0.0f), scale(1.0f);
+  bool quantized = std::any_of(format.elements.begin(), format.elements.end(), [](const VertexElement& element) {
+    return element.attribute == VertexAttribute::Position && element.encoding == VertexEncoding::Snorm16;
+  });
+
+  if (quantized) {
+    vec3 minBounds = vertices[0].position;
+    vec3 maxBounds = vertices[0].position;
+
+    for (const auto& vertex : vertices) {
+      minBounds = vec3(std::min(minBounds.x, vertex.position.x), std::min(minBounds.y, vertex.position.y), std::min(minBounds.z, vertex.position.z));
+      maxBounds = vec3(std::max(maxBounds.x, vertex.position.x), std::max(maxBounds.y, vertex.position.y), std::max(maxBounds.z, vertex.position.z));
+    }
+
+    offset = (minBounds + maxBounds) * 0.5f;
+    vec3 extent = (maxBounds - minBounds) * 0.5f;
+    scale = vec3(std::max(extent.x, 1e-6f), std::max(extent.y, 1e-6f), std::max(extent.z, 1e-6f));
+  }
+
+  std::vector<unsigned char> encoded = encodeVertices(format, vertices, offset, scale);
+
   vk::Buffer vertexStaging = m_allocator->allocateBuffer(vk::BufferCreateInfo{
-    .size   = sizeof(Vertex) * vertices.size(),
+    .size   = encoded.size(),
     .usage  = vk::BufferUsageFlagBits::eTransferSrc
   });
 
   void * map = m_allocator->mapBuffer(vertexStaging);
-  std::memcpy(map, vertices.data(), sizeof(Vertex) * vertices.size());
+  std::memcpy(map, encoded.data(), encoded.size());
   m_allocator->unmapBuffer(vertexStaging);
 
   vk::Buffer indexStaging = m_allocator->allocateBuffer(vk::BufferCreateInfo{
@@ -1514,7 +1883,7 @@ RID Engine::load_mesh(const std::string& path) {
   m_allocator->unmapBuffer(indexStaging);
 
   vk::Buffer vertexBuffer = m_allocator->allocateBuffer(vk::BufferCreateInfo{
-    .size   = sizeof(Vertex) * vertices.size(),
+    .size   = encoded.size(),
     .usage  = vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eTransferDst
   }, VMA_MEMORY_USAGE_GPU_ONLY, 0);
 
@@ -1528,7 +1897,7 @@ RID Engine::load_mesh(const std::string& path) {
   cmd.begin(vk::CommandBufferBeginInfo{ .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
 
   cmd.copyBuffer(vertexStaging, vertexBuffer, vk::BufferCopy{
-    .size = sizeof(Vertex) * vertices.size()
+    .size = encoded.size()
   });
 
   cmd.copyBuffer(indexStaging, indexBuffer, vk::BufferCopy{
@@ -1550,6 +1919,9 @@ RID Engine::load_mesh(const std::string& path) {
   mesh->vertexBuffer = vertexBuffer;
   mesh->indexBuffer = indexBuffer;
   mesh->indexCount = indices.size();
+  mesh->formatKey = vertexFormatKey(format, fnv1aOffset);
+  mesh->offset = offset;
+  mesh->scale = scale;
 
   RID rid(m_nextRID++, ResourceType::Mesh);
   m_resources[rid] = reinterpret_cast<unsigned long>(mesh);
@@ -1565,6 +1937,21 @@ RID Engine::load_mesh(const std::string& path) {
   return rid;
 }
 
+mat4 Engine::mesh_dequantization(const RID& rid) const {
+  if (!rid.is_valid()) {
+    Log::warn("tried to get dequantization of invalid mesh RID");
+    return mat4::identity();
+  }
+
+  if (rid.m_type != ResourceType::Mesh) {
+    Log::warn("tried to get dequantization of non-mesh RID");
+    return mat4::identity();
+  }
+
+  MeshHandle * mesh = reinterpret_cast<MeshHandle *>(m_resources.at(rid));
+  return mat4::translation(mesh->offset) * mat4::scale(mesh->scale.x, mesh->scale.y, mesh->scale.z);
+}
+
 void Engine::destroy_mesh(RID& rid) {
   if (!rid.is_valid()) {
     Log::warn("tried to destroy invalid mesh RID");
@@ -1588,16 +1975,6 @@ void Engine::destroy_mesh(RID& rid) {
 }
 
 void Engine::dispatch(const ComputeCommand& cmd) {
-  if (!cmd.descriptor_set.is_valid()) {
-    Log::warn("Tried to dispatch compute command with invalid descriptor set");
-    return;
-  }
-
-  if (cmd.descriptor_set.m_type != ResourceType::DescriptorSet) {
-    Log::warn("Tried to dispatch compute command with non-descriptor-set RID");
-    return;
-  }
-
   if (!cmd.pipeline.is_valid()) {
     Log::warn("Tried to dispatch compute command with invalid pipeline");
     return;
@@ -1608,48 +1985,1396 @@ void Engine::dispatch(const ComputeCommand& cmd) {
     return;
   }
 
-  m_renderer->dispatch(m_context, cmd, m_resources);
-}
+  PipelineHandle * pipeline = reinterpret_cast<PipelineHandle *>(m_resources.at(cmd.pipeline));
+  if (!pipeline->pipeline) {
+    RID fallback = pipeline->fallback;
+    if (!fallback.is_valid() || !m_resources.contains(fallback)) return;
+    if (!reinterpret_cast<PipelineHandle *>(m_resources.at(fallback))->pipeline) return;
 
-void Engine::add_to_scene(Object& object) {
-  if (object.is_in_scene()) {
-    Log::warn("tried to add object to scene that was already added to the scene");
+    ComputeCommand command = cmd;
+    command.pipeline = fallback;
+    dispatch(command);
     return;
   }
 
-  object.m_id.m_id = m_nextRID++;
-  m_scene.emplace(object);
-}
-
-void Engine::remove_from_scene(Object& object) {
-  if (!object.is_in_scene()) {
-    Log::warn("tried to remove object from scene that was not in the scene");
+  if (cmd.push_constants.size() > pipeline->reflection.pushConstantSize) {
+    Log::warn(std::format(
+      "Tried to dispatch compute command with {} bytes of push constants but the shader declares {}",
+      cmd.push_constants.size(), pipeline->reflection.pushConstantSize
+    ));
     return;
   }
 
-  m_scene.erase(object);
-  object.m_id.invalidate();
-}
+  if (pipeline->pushDescriptors) {
+    DescriptorWrites described;
+    if (!describeDescriptors(cmd.push_descriptors, described)) return;
 
-void Engine::add_gui(const std::string& label, GUI&& gui) {
-  if (m_guis.contains(label))
-    Log::runtime_error(std::format("Duplicate GUIs with label \"{}\"", label));
+    if (!described.targets.empty()) {
+      Log::warn("Tried to push the render target as a descriptor. use a descriptor set instead");
+      return;
+    }
 
-  m_guis.emplace(label, std::move(gui));
-}
+    if (!validateBindings({ described.bindings }, pipeline->reflection)) {
+      Log::warn("Tried to dispatch compute command with push descriptors that do not match the shader");
+      return;
+    }
+
+    const auto& declared = pipeline->bindings[0];
+    bool undeclared = std::any_of(described.bindings.begin(), described.bindings.end(), [&declared](const auto& binding) {
+      return std::none_of(declared.begin(), declared.end(), [&binding](const auto& expected) {
+        return expected.binding == binding.binding;
+      });
+    });
+
+    if (undeclared) {
+      Log::warn("Tried to dispatch compute command with more push descriptors than the shader declares bindings. push descriptor i is written to binding i");
+      return;
+    }
+
+    m_renderer->dispatch(m_context, cmd, m_resources, described.writes);
+    return;
+  }
+
+  if (!cmd.descriptor_set.is_valid()) {
+    Log::warn("Tried to dispatch compute command with invalid descriptor set");
+    return;
+  }
+
+  if (cmd.descriptor_set.m_type != ResourceType::DescriptorSet) {
+    Log::warn("Tried to dispatch compute command with non-descriptor-set RID");
+    return;
+  }
+
+  if (m_renderer->preDraw() && !reinterpret_cast<DescriptorSetHandle *>(m_resources.at(cmd.descriptor_set))->targets.empty()) {
+    Log::warn("Tried to dispatch compute command that uses the render target before drawing");
+    return;
+  }
+
+  m_renderer->dispatch(m_context, cmd, m_resources);
+}
+
+void Engine::add_to_scene(Object& object) {
+  if (object.is_in_scene()) {
+    Log::warn("tried to add object to scene that was already added to the scene");
+    return;
+  }
+
+  for (const auto& rid : object.m_sets) {
+    if (!m_resources.contains(rid) || rid.m_type != ResourceType::DescriptorSet) continue;
+
+    if (!reinterpret_cast<DescriptorSetHandle *>(m_resources.at(rid))->targets.empty()) {
+      Log::warn("tried to add object to scene with a render target descriptor set. render targets can only be used in post-draw dispatches");
+      return;
+    }
+  }
+
+  if (m_resources.contains(object.m_pipeline)) {
+    const PipelineHandle * pipeline = reinterpret_cast<PipelineHandle *>(m_resources.at(object.m_pipeline));
+    if (object.m_pushConstants.size() > pipeline->reflection.pushConstantSize) {
+      Log::warn(std::format(
+        "tried to add object to scene with {} bytes of push constants but its shaders declare {}",
+        object.m_pushConstants.size(), pipeline->reflection.pushConstantSize
+      ));
+      return;
+    }
+
+    const MeshHandle * mesh = m_resources.contains(object.m_mesh) ? reinterpret_cast<MeshHandle *>(m_resources.at(object.m_mesh)) : nullptr;
+    if (mesh && mesh->formatKey != vertexFormatKey(pipeline->settings.vertex_format, fnv1aOffset)) {
+      Log::warn("tried to add object to scene whose mesh vertex format does not match its pipeline");
+      return;
+    }
+  }
+
+  bool overridesState = object.m_cullMode || object.m_drawDirection || object.m_depthTest || object.m_depthWrite || object.m_depthCompare;
+  if (overridesState && !m_context->supportsDynamicState())
+    Log::warn("object overrides pipeline state but dynamic pipeline state is unavailable. the pipeline's settings are used instead");
+  if (object.m_blend && !m_context->supportsDynamicBlend())
+    Log::warn("object overrides blending but dynamic blend state is unavailable. the pipeline's setting is used instead");
+
+  object.m_id.m_id = m_nextRID++;
+  m_scene.emplace(object);
+}
+
+void Engine::remove_from_scene(Object& object) {
+  if (!object.is_in_scene()) {
+    Log::warn("tried to remove object from scene that was not in the scene");
+    return;
+  }
+
+  m_scene.erase(object);
+  object.m_id.invalidate();
+}
+
+void Engine::add_gui(const std::string& label, GUI&& gui) {
+  if (m_guis.contains(label))
+    Log::runtime_error(std::format("Duplicate GUIs with label \"{}\"", label));
+
+  m_guis.emplace(label, std::move(gui));
+}
 
 void Engine::toggle_gui(const std::string& gui) {
   m_guis.at(gui).toggle();
 }
 
-void Engine::updateTimes() {
-  static std::chrono::time_point start = std::chrono::high_resolution_clock::now();
-  std::chrono::time_point now = std::chrono::high_resolution_clock::now();
+void Engine::updateTimes() {
+  static std::chrono::time_point start = std::chrono::high_resolution_clock::now();
+  std::chrono::time_point now = std::chrono::high_resolution_clock::now();
+
+  double time = std::chrono::duration(now - start).count();
+
+  m_frameTime = std::min(time - m_time, 0.25);
+  m_time = time;
+}
+
+RID Engine::createTexture(unsigned int width, unsigned int height, unsigned int layers, const unsigned char * pixels, const RID& sampler) {
+  std::size_t size = static_cast<std::size_t>(width) * height * 4 * layers;
+
+  vk::Buffer buffer = m_allocator->allocateBuffer(vk::BufferCreateInfo{
+    .size   = size,
+    .usage  = vk::BufferUsageFlagBits::eTransferSrc
+  });
+
+  void * map = m_allocator->mapBuffer(buffer);
+  std::memcpy(map, pixels, size);
+  m_allocator->unmapBuffer(buffer);
+
+  vk::Image image = m_allocator->allocateImage(vk::ImageCreateInfo{
+    .imageType    = vk::ImageType::e2D,
+    .format       = vk::Format::eR8G8B8A8Srgb,
+    .extent       = { width, height, 1 },
+    .mipLevels    = 1,
+    .arrayLayers  = layers,
+    .samples      = vk::SampleCountFlagBits::e1,
+    .tiling       = vk::ImageTiling::eOptimal,
+    .usage        = vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferDst
+  });
+
+  std::vector<vk::CommandBuffer> cmds = m_context->transferCmds(1);
+  vk::CommandBuffer& cmd = cmds[0];
+  cmd.begin(vk::CommandBufferBeginInfo{ .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+
+  vk::ImageMemoryBarrier copyBarrier{
+    .dstAccessMask    = vk::AccessFlagBits::eTransferWrite,
+    .newLayout        = vk::ImageLayout::eTransferDstOptimal,
+    .image            = image,
+    .subresourceRange = {
+      .aspectMask = vk::ImageAspectFlagBits::eColor,
+      .levelCount = 1,
+      .layerCount = layers
+    }
+  };
+
+  cmd.pipelineBarrier(
+    vk::PipelineStageFlagBits::eTopOfPipe,
+    vk::PipelineStageFlagBits::eTransfer,
+    vk::DependencyFlags(),
+    nullptr,
+    nullptr,
+    copyBarrier
+  );
+
+  cmd.copyBufferToImage(buffer, image, vk::ImageLayout::eTransferDstOptimal, vk::BufferImageCopy{
+    .imageSubresource = {
+      .aspectMask = vk::ImageAspectFlagBits::eColor,
+      .layerCount = layers
+    },
+    .imageExtent = { width, height, 1 }
+  });
+
+  vk::ImageMemoryBarrier shaderBarrier{
+    .srcAccessMask    = vk::AccessFlagBits::eTransferWrite,
+    .dstAccessMask    = vk::AccessFlagBits::eShaderRead,
+    .oldLayout        = vk::ImageLayout::eTransferDstOptimal,
+    .newLayout        = vk::ImageLayout::eShaderReadOnlyOptimal,
+    .image            = image,
+    .subresourceRange = {
+      .aspectMask = vk::ImageAspectFlagBits::eColor,
+      .levelCount = 1,
+      .layerCount = layers
+    }
+  };
+
+  cmd.pipelineBarrier(
+    vk::PipelineStageFlagBits::eTransfer,
+    vk::PipelineStageFlagBits::eFragmentShader,
+    vk::DependencyFlags(),
+    nullptr,
+    nullptr,
+    shaderBarrier
+  );
+
+  cmd.end();
+
+  vk::Fence fence = m_context->device().createFence({});
+
+  auto [index, queue] = m_context->transferQueue();
+  queue.submit(vk::SubmitInfo{
+    .commandBufferCount = 1,
+    .pCommandBuffers    = &cmd
+  }, fence);
+
+  vk::ImageView view = m_context->device().createImageView(vk::ImageViewCreateInfo{
+    .image = image,
+    .viewType = layers > 1 ? vk::ImageViewType::e2DArray : vk::ImageViewType::e2D,
+    .format = vk::Format::eR8G8B8A8Srgb,
+    .components = {
+      .r = vk::ComponentSwizzle::eIdentity,
+      .g = vk::ComponentSwizzle::eIdentity,
+      .b = vk::ComponentSwizzle::eIdentity,
+      .a = vk::ComponentSwizzle::eIdentity
+    },
+    .subresourceRange = {
+      .aspectMask = vk::ImageAspectFlagBits::eColor,
+      .levelCount = 1,
+      .layerCount = layers
+    }
+  });
+
+  ImageHandle * handle = new ImageHandle;
+  handle->image = image;
+  handle->view = view;
+  handle->sampler = sampler;
+  handle->format = vk::Format::eR8G8B8A8Srgb;
+  handle->extent = vk::Extent3D{ width, height, 1 };
+  handle->layers = layers;
+
+  RID rid(m_nextRID++, ResourceType::Texture);
+  m_resources[rid] = reinterpret_cast<unsigned long>(handle);
+  m_busySamplers.emplace(sampler);
+  registerBindless(rid);
+
+  if (m_context->device().waitForFences(fence, true, 1000000000) != vk::Result::eSuccess)
+    Log::runtime_error("Hung waiting for texture transition");
+
+  m_allocator->destroyBuffer(buffer);
+  m_context->device().destroyFence(fence);
+  m_context->destroyTransferCmds(cmds);
+
+  return rid;
+}
+
+RID Engine::registerPipeline(PipelineHandle * pipeline, bool async) {
+  pipeline->key = pipelineKey(pipeline);
+  if (auto it = m_pipelineStates.find(pipeline->key); it != m_pipelineStates.end()) {
+    releasePipelineLayout(pipeline->layoutKey);
+    for (unsigned long key : pipeline->setLayoutKeys) releaseSetLayout(key);
+    delete pipeline;
+
+    RID rid = it->second;
+    PipelineHandle * existing = reinterpret_cast<PipelineHandle *>(m_resources.at(rid));
+    if (!async && existing->pending.valid()) {
+      std::erase(m_pendingPipelines, rid);
+      finishPipeline(rid);
+      if (!existing->pipeline) return RID();
+    }
+
+    ++m_refCounts.at(rid);
+    return rid;
+  }
+
+  resolveModules(pipeline);
+
+  if (async) {
+    pipeline->pending = m_workers->submit([this, pipeline] { return buildPipeline(pipeline); });
+
+    RID rid(m_nextRID++, ResourceType::Pipeline);
+    m_resources[rid] = reinterpret_cast<unsigned long>(pipeline);
+    m_pipelineStates[pipeline->key] = rid;
+    m_refCounts[rid] = 1;
+    m_pendingPipelines.emplace_back(rid);
+
+    return rid;
+  }
+
+  pipeline->pipeline = buildPipeline(pipeline);
+  if (!pipeline->pipeline) {
+    Log::warn(std::format("failed to create {} pipeline", pipeline->bindPoint == vk::PipelineBindPoint::eCompute ? "compute" : "graphics"));
+
+    releasePipelineLayout(pipeline->layoutKey);
+    for (unsigned long key : pipeline->setLayoutKeys) releaseSetLayout(key);
+    delete pipeline;
+
+    return RID();
+  }
+
+  RID rid(m_nextRID++, ResourceType::Pipeline);
+  m_resources[rid] = reinterpret_cast<unsigned long>(pipeline);
+  m_pipelineStates[pipeline->key] = rid;
+  m_refCounts[rid] = 1;
+  optimizePipeline(rid);
+
+  return rid;
+}
+
+void Engine::finishPipeline(const RID& rid) {
+  PipelineHandle * pipeline = reinterpret_cast<PipelineHandle *>(m_resources.at(rid));
+  pipeline->pipeline = pipeline->pending.get();
+  if (pipeline->pipeline) {
+    optimizePipeline(rid);
+    return;
+  }
+
+  Log::warn(std::format("failed to create {} pipeline", pipeline->bindPoint == vk::PipelineBindPoint::eCompute ? "compute" : "graphics"));
+  m_pipelineStates.erase(pipeline->key);
+}
+
+void Engine::resolvePipelines() {
+  std::erase_if(m_pendingPipelines, [this](const RID& rid) {
+    PipelineHandle * pipeline = reinterpret_cast<PipelineHandle *>(m_resources.at(rid));
+    if (pipeline->pending.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return false;
+
+    finishPipeline(rid);
+    return true;
+  });
+
+  std::erase_if(m_optimizingPipelines, [this](const RID& rid) {
+    PipelineHandle * pipeline = reinterpret_cast<PipelineHandle *>(m_resources.at(rid));
+    if (pipeline->optimized.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return false;
+
+    vk::Pipeline optimized = pipeline->optimized.get();
+    if (!optimized) return true;
+
+    vk::Pipeline old = pipeline->pipeline;
+    deferDeletion([this, old] { m_context->device().destroyPipeline(old); });
+    pipeline->pipeline = optimized;
+
+    return true;
+  });
+}
+
+bool Engine::validateFallback(const RID& fallback, const PipelineHandle * pipeline) const {
+  if (!fallback.is_valid()) return false;
+
+  if (fallback.m_type != ResourceType::Pipeline || !m_resources.contains(fallback)) {
+    Log::warn("fallback RID is not a pipeline RID. the pipeline will be skipped until it is ready");
+    return false;
+  }
+
+  const PipelineHandle * handle = reinterpret_cast<PipelineHandle *>(m_resources.at(fallback));
+  if (handle->bindPoint != pipeline->bindPoint) {
+    Log::warn("fallback pipeline has a different bind point. the pipeline will be skipped until it is ready");
+    return false;
+  }
+
+  if (handle->pushDescriptors != pipeline->pushDescriptors) {
+    Log::warn("fallback pipeline binds descriptors differently. the pipeline will be skipped until it is ready");
+    return false;
+  }
+
+  if (pipeline->bindPoint == vk::PipelineBindPoint::eGraphics &&
+      vertexFormatKey(handle->settings.vertex_format, fnv1aOffset) != vertexFormatKey(pipeline->settings.vertex_format, fnv1aOffset)) {
+    Log::warn("fallback pipeline has a different vertex format. the pipeline will be skipped until it is ready");
+    return false;
+  }
+
+  if (handle->layoutKey != pipeline->layoutKey) {
+    Log::warn("fallback pipeline has different descriptor set layouts or push constants. the pipeline will be skipped until it is ready");
+    return false;
+  }
+
+  return true;
+}
+
+unsigned long Engine::pipelineKey(const PipelineHandle * pipeline) const {
+  unsigned long key = fnv1aValue(pipeline->bindPoint);
+  key = fnv1aValue(pipeline->layoutKey, key);
+
+  if (pipeline->bindPoint == vk::PipelineBindPoint::eCompute) {
+    key = fnv1aValue(*pipeline->compute, key);
+  }
+  else {
+    const GraphicsPipelineShaders& shaders = pipeline->shaders;
+    for (const RID& shader : { shaders.vertex, shaders.fragment, shaders.tesselation_control, shaders.tesselation_evaluation })
+      key = fnv1aValue(*shader, key);
+
+    const GraphicsPipelineSettings& s = pipeline->settings;
+    key = fnv1aValue(s.mesh_type, key);
+    key = vertexFormatKey(s.vertex_format, key);
+    if (!m_context->supportsDynamicState()) {
+      key = fnv1aValue(s.cull_mode, key);
+      key = fnv1aValue(s.draw_direction, key);
+      key = fnv1aValue(s.enable_depth_test, key);
+      key = fnv1aValue(s.enable_depth_write, key);
+      key = fnv1aValue(s.depth_compare, key);
+    }
+    if (!m_context->supportsDynamicBlend())
+      key = fnv1aValue(s.enable_blend, key);
+  }
+
+  for (const auto& [id, value] : pipeline->specialization.values) {
+    key = fnv1aValue(id, key);
+    key = fnv1a(value.data(), value.size(), key);
+  }
+
+  return key;
+}
+
+vk::Pipeline Engine::buildPipeline(PipelineHandle * pipeline) {
+  std::vector<vk::SpecializationMapEntry> specializationEntries;
+  std::vector<unsigned char> specializationData;
+  for (const auto& [id, value] : pipeline->specialization.values) {
+    specializationEntries.emplace_back(vk::SpecializationMapEntry{
+      .constantID = id,
+      .offset     = static_cast<unsigned int>(specializationData.size()),
+      .size       = value.size()
+    });
+    specializationData.insert(specializationData.end(), value.begin(), value.end());
+  }
+
+  vk::SpecializationInfo specializationInfo{
+    .mapEntryCount  = static_cast<unsigned int>(specializationEntries.size()),
+    .pMapEntries    = specializationEntries.data(),
+    .dataSize       = specializationData.size(),
+    .pData          = specializationData.data()
+  };
+  const vk::SpecializationInfo * specialization = specializationEntries.empty() ? nullptr : &specializationInfo;
+
+  for (const auto& [stage, module] : pipeline->modules)
+    if (!module) return nullptr;
+
+  if (pipeline->bindPoint == vk::PipelineBindPoint::eCompute) {
+    if (pipeline->modules.empty()) return nullptr;
+
+    vk::ComputePipelineCreateInfo pipelineCreateInfo{
+      .flags  = m_context->pipelineCreateFlags(),
+      .stage  = vk::PipelineShaderStageCreateInfo{
+        .stage                = vk::ShaderStageFlagBits::eCompute,
+        .module               = pipeline->modules.front().second,
+        .pName                = "main",
+        .pSpecializationInfo  = specialization
+      },
+      .layout = pipeline->layout
+    };
+
+    vk::ResultValue<vk::Pipeline> result = m_context->device().createComputePipeline(m_context->pipelineCache(), pipelineCreateInfo);
+    return result.has_value() ? result.value : nullptr;
+  }
+
+  const GraphicsPipelineSettings& s = pipeline->settings;
+
+  std::vector<vk::PipelineShaderStageCreateInfo> stages = {};
+  for (const auto& [stage, module] : pipeline->modules) {
+    stages.emplace_back(vk::PipelineShaderStageCreateInfo{
+      .stage                = stage,
+      .module               = module,
+      .pName                = "main",
+      .pSpecializationInfo  = specialization
+    });
+  }
+
+  std::vector<vk::DynamicState> dynamicStates = {
+    vk::DynamicState::eViewport,
+    vk::DynamicState::eScissor
+  };
+
+  if (m_context->supportsDynamicState()) {
+    dynamicStates.insert(dynamicStates.end(), {
+      vk::DynamicState::eCullMode,
+      vk::DynamicState::eFrontFace,
+      vk::DynamicState::eDepthTestEnable,
+      vk::DynamicState::eDepthWriteEnable,
+      vk::DynamicState::eDepthCompareOp
+    });
+  }
+
+  if (m_context->supportsDynamicBlend())
+    dynamicStates.emplace_back(vk::DynamicState::eColorBlendEnableEXT);
+
+  vk::PipelineDynamicStateCreateInfo dynamicStateCreateInfo{
+    .dynamicStateCount  = static_cast<unsigned int>(dynamicStates.size()),
+    .pDynamicStates     = dynamicStates.data()
+  };
+
+  vk::PipelineViewportStateCreateInfo viewportStateCreateInfo{
+    .viewportCount  = 1,
+    .scissorCount   = 1
+  };
+
+  vk::VertexInputBindingDescription binding{
+    .binding    = 0,
+    .stride     = s.vertex_format.stride,
+    .inputRate  = vk::VertexInputRate::eVertex
+  };
+
+  std::vector<vk::VertexInputAttributeDescription> attributes;
+  for (const auto& element : s.vertex_format.elements) {
+    attributes.emplace_back(vk::VertexInputAttributeDescription{
+      .location = static_cast<unsigned int>(element.attribute),
+      .binding  = 0,
+      .format   = static_cast<vk::Format>(element.format),
+      .offset   = element.offset
+    });
+  }
+
+  vk::PipelineVertexInputStateCreateInfo vertexInputCreateInfo{
+    .vertexBindingDescriptionCount    = 1,
+    .pVertexBindingDescriptions       = &binding,
+    .vertexAttributeDescriptionCount  = static_cast<unsigned int>(attributes.size()),
+    .pVertexAttributeDescriptions     = attributes.data()
+  };
+
+  vk::PipelineInputAssemblyStateCreateInfo assemblyCreateInfo{
+    .topology               = vk::PrimitiveTopology::eTriangleList,
+    .primitiveRestartEnable = false
+  };
+
+  vk::PolygonMode polygonMode = static_cast<vk::PolygonMode>(s.mesh_type);
+  if (s.mesh_type != MeshType::Solid && !m_context->supportsNonSolidMesh()) {
+    Log::warn("setting pipeline mesh type to solid. GPU does not support non solid meshes");
+    polygonMode = vk::PolygonMode::eFill;
+  }
+
+  vk::PipelineRasterizationStateCreateInfo rasterizerCreateInfo{
+    .depthClampEnable         = false,
+    .rasterizerDiscardEnable  = false,
+    .polygonMode              = polygonMode,
+    .cullMode                 = static_cast<vk::CullModeFlagBits>(s.cull_mode),
+    .frontFace                = static_cast<vk::FrontFace>(s.draw_direction),
+    .depthBiasEnable          = false,
+    .lineWidth                = 1.0f
+  };
+
+  vk::PipelineMultisampleStateCreateInfo multisampleCreateInfo{
+    .rasterizationSamples = vk::SampleCountFlagBits::e1,
+    .sampleShadingEnable  = false
+  };
+
+  vk::PipelineDepthStencilStateCreateInfo depthCreateInfo{
+    .depthTestEnable        = s.enable_depth_test,
+    .depthWriteEnable       = s.enable_depth_write,
+    .depthCompareOp         = static_cast<vk::CompareOp>(s.depth_compare),
+    .depthBoundsTestEnable  = false,
+    .stencilTestEnable      = false
+  };
+
+  vk::PipelineColorBlendAttachmentState colorAttachmentState{
+    .blendEnable          = s.enable_blend,
+    .srcColorBlendFactor  = vk::BlendFactor::eSrcAlpha,
+    .dstColorBlendFactor  = vk::BlendFactor::eOneMinusSrcAlpha,
+    .colorBlendOp         = vk::BlendOp::eAdd,
+    .srcAlphaBlendFactor  = vk::BlendFactor::eOneMinusSrcAlpha,
+    .alphaBlendOp         = vk::BlendOp::eAdd,
+    .colorWriteMask       = vk::ColorComponentFlagBits::eR |
+                            vk::ColorComponentFlagBits::eG |
+                            vk::ColorComponentFlagBits::eB |
+                            vk::ColorComponentFlagBits::eA
+  };
+
+  vk::PipelineColorBlendStateCreateInfo blendStateCreateInfo{
+    .logicOpEnable    = false,
+    .attachmentCount  = 1,
+    .pAttachments     = &colorAttachmentState
+  };
+
+  vk::Format colorFormat = m_renderer->colorFormat();
+  vk::PipelineRenderingCreateInfo renderingCreateInfo{
+    .colorAttachmentCount     = 1,
+    .pColorAttachmentFormats  = &colorFormat,
+    .depthAttachmentFormat    = m_renderer->depthFormat()
+  };
+
+  vk::GraphicsPipelineCreateInfo pipelineCreateInfo{
+    .pNext                = &renderingCreateInfo,
+    .flags                = m_context->pipelineCreateFlags(),
+    .stageCount           = static_cast<unsigned int>(stages.size()),
+    .pStages              = stages.data(),
+    .pVertexInputState    = &vertexInputCreateInfo,
+    .pInputAssemblyState  = &assemblyCreateInfo,
+    .pViewportState       = &viewportStateCreateInfo,
+    .pRasterizationState  = &rasterizerCreateInfo,
+    .pMultisampleState    = &multisampleCreateInfo,
+    .pDepthStencilState   = &depthCreateInfo,
+    .pColorBlendState     = &blendStateCreateInfo,
+    .pDynamicState        = &dynamicStateCreateInfo,
+    .layout               = pipeline->layout
+  };
+
+  if (!m_context->supportsPipelineLibraries()) {
+    vk::ResultValue<vk::Pipeline> result = m_context->device().createGraphicsPipeline(m_context->pipelineCache(), pipelineCreateInfo);
+    return result.has_value() ? result.value : nullptr;
+  }
+
+  unsigned long shared = fnv1aValue(pipeline->layoutKey);
+  for (const auto& [id, value] : pipeline->specialization.values) {
+    shared = fnv1aValue(id, shared);
+    shared = fnv1a(value.data(), value.size(), shared);
+  }
+
+  unsigned long vertexInputKey = vertexFormatKey(s.vertex_format, fnv1aValue(vk::GraphicsPipelineLibraryFlagBitsEXT::eVertexInputInterface));
+  unsigned long preRasterKey = fnv1aValue(vk::GraphicsPipelineLibraryFlagBitsEXT::ePreRasterizationShaders, shared);
+  unsigned long fragmentKey = fnv1aValue(vk::GraphicsPipelineLibraryFlagBitsEXT::eFragmentShader, shared);
+  unsigned long outputKey = fnv1aValue(vk::GraphicsPipelineLibraryFlagBitsEXT::eFragmentOutputInterface);
+
+  std::vector<vk::PipelineShaderStageCreateInfo> preRasterStages, fragmentStages;
+  for (unsigned int i = 0; i < stages.size(); ++i) {
+    if (stages[i].stage == vk::ShaderStageFlagBits::eFragment) {
+      fragmentStages.emplace_back(stages[i]);
+      fragmentKey = fnv1aValue(pipeline->moduleKeys[i], fragmentKey);
+    }
+    else {
+      preRasterStages.emplace_back(stages[i]);
+      preRasterKey = fnv1aValue(stages[i].stage, preRasterKey);
+      preRasterKey = fnv1aValue(pipeline->moduleKeys[i], preRasterKey);
+    }
+  }
+
+  preRasterKey = fnv1aValue(polygonMode, preRasterKey);
+  if (!m_context->supportsDynamicState()) {
+    preRasterKey = fnv1aValue(s.cull_mode, preRasterKey);
+    preRasterKey = fnv1aValue(s.draw_direction, preRasterKey);
+    fragmentKey = fnv1aValue(s.enable_depth_test, fragmentKey);
+    fragmentKey = fnv1aValue(s.enable_depth_write, fragmentKey);
+    fragmentKey = fnv1aValue(s.depth_compare, fragmentKey);
+  }
+  if (!m_context->supportsDynamicBlend())
+    outputKey = fnv1aValue(s.enable_blend, outputKey);
+
+  auto library = [this, &renderingCreateInfo, &dynamicStateCreateInfo](vk::GraphicsPipelineLibraryFlagBitsEXT part, unsigned long key, vk::GraphicsPipelineCreateInfo createInfo) {
+    vk::GraphicsPipelineLibraryCreateInfoEXT libraryCreateInfo{
+      .pNext  = &renderingCreateInfo,
+      .flags  = part
+    };
+
+    createInfo.pNext = &libraryCreateInfo;
+    createInfo.flags = m_context->pipelineCreateFlags() | vk::PipelineCreateFlagBits::eLibraryKHR | vk::PipelineCreateFlagBits::eRetainLinkTimeOptimizationInfoEXT;
+    createInfo.pDynamicState = &dynamicStateCreateInfo;
+
+    return std::make_pair(key, acquirePipelineLibrary(key, createInfo));
+  };
+
+  pipeline->libraries = {
+    library(vk::GraphicsPipelineLibraryFlagBitsEXT::eVertexInputInterface, vertexInputKey, {
+      .pVertexInputState    = &vertexInputCreateInfo,
+      .pInputAssemblyState  = &assemblyCreateInfo
+    }),
+    library(vk::GraphicsPipelineLibraryFlagBitsEXT::ePreRasterizationShaders, preRasterKey, {
+      .stageCount           = static_cast<unsigned int>(preRasterStages.size()),
+      .pStages              = preRasterStages.data(),
+      .pViewportState       = &viewportStateCreateInfo,
+      .pRasterizationState  = &rasterizerCreateInfo,
+      .layout               = pipeline->layout
+    }),
+    library(vk::GraphicsPipelineLibraryFlagBitsEXT::eFragmentShader, fragmentKey, {
+      .stageCount           = static_cast<unsigned int>(fragmentStages.size()),
+      .pStages              = fragmentStages.data(),
+      .pMultisampleState    = &multisampleCreateInfo,
+      .pDepthStencilState   = &depthCreateInfo,
+      .layout               = pipeline->layout
+    }),
+    library(vk::GraphicsPipelineLibraryFlagBitsEXT::eFragmentOutputInterface, outputKey, {
+      .pMultisampleState    = &multisampleCreateInfo,
+      .pColorBlendState     = &blendStateCreateInfo
+    })
+  };
+
+  for (const auto& [key, library] : pipeline->libraries) {
+    if (library) continue;
+
+    releasePipelineLibraries(pipeline);
+    return nullptr;
+  }
+
+  vk::Pipeline linked = linkPipeline(pipeline, false);
+  if (!linked) releasePipelineLibraries(pipeline);
+
+  return linked;
+}
+
+vk::Pipeline Engine::linkPipeline(const PipelineHandle * pipeline, bool optimize) const {
+  std::vector<vk::Pipeline> libraries;
+  for (const auto& [key, library] : pipeline->libraries)
+    libraries.emplace_back(library);
+
+  vk::PipelineLibraryCreateInfoKHR libraryCreateInfo{
+    .libraryCount = static_cast<unsigned int>(libraries.size()),
+    .pLibraries   = libraries.data()
+  };
+
+  vk::GraphicsPipelineCreateInfo pipelineCreateInfo{
+    .pNext  = &libraryCreateInfo,
+    .flags  = m_context->pipelineCreateFlags() | (optimize ? vk::PipelineCreateFlagBits::eLinkTimeOptimizationEXT : vk::PipelineCreateFlags()),
+    .layout = pipeline->layout
+  };
+
+  vk::ResultValue<vk::Pipeline> result = m_context->device().createGraphicsPipeline(m_context->pipelineCache(), pipelineCreateInfo);
+  return result.has_value() ? result.value : nullptr;
+}
+
+vk::Pipeline Engine::acquirePipelineLibrary(unsigned long key, const vk::GraphicsPipelineCreateInfo& createInfo) {
+  {
+    std::lock_guard lock(m_libraryMutex);
+    if (auto it = m_pipelineLibraries.find(key); it != m_pipelineLibraries.end()) {
+      ++it->second.second;
+      return reinterpret_cast<VkPipeline>(it->second.first);
+    }
+  }
+
+  vk::ResultValue<vk::Pipeline> result = m_context->device().createGraphicsPipeline(m_context->pipelineCache(), createInfo);
+  if (!result.has_value()) return nullptr;
+
+  std::lock_guard lock(m_libraryMutex);
+  auto [it, inserted] = m_pipelineLibraries.try_emplace(key, reinterpret_cast<unsigned long>(static_cast<VkPipeline>(result.value)), 0);
+  if (!inserted) m_context->device().destroyPipeline(result.value);
+
+  ++it->second.second;
+  return reinterpret_cast<VkPipeline>(it->second.first);
+}
+
+void Engine::releasePipelineLibraries(PipelineHandle * pipeline) {
+  std::lock_guard lock(m_libraryMutex);
+  for (const auto& [key, library] : pipeline->libraries) {
+    auto it = m_pipelineLibraries.find(key);
+    if (it == m_pipelineLibraries.end() || --it->second.second > 0) continue;
+
+    m_context->device().destroyPipeline(reinterpret_cast<VkPipeline>(it->second.first));
+    m_pipelineLibraries.erase(it);
+  }
+
+  pipeline->libraries.clear();
+}
+
+void Engine::optimizePipeline(const RID& rid) {
+  PipelineHandle * pipeline = reinterpret_cast<PipelineHandle *>(m_resources.at(rid));
+  if (!m_settings.optimize_pipeline_libraries || pipeline->libraries.empty() || !pipeline->pipeline) return;
+
+  pipeline->optimized = m_workers->submit([this, pipeline] { return linkPipeline(pipeline, true); });
+  m_optimizingPipelines.emplace_back(rid);
+}
+
+vk::ShaderModule Engine::shaderModule(const RID& rid) const {
+  if (!rid.is_valid() || !m_resources.contains(rid)) return nullptr;
+  return reinterpret_cast<ShaderHandle *>(m_resources.at(rid))->module;
+}
+
+void Engine::resolveModules(PipelineHandle * pipeline) const {
+  pipeline->modules.clear();
+  pipeline->moduleKeys.clear();
+
+  auto resolve = [this, pipeline](vk::ShaderStageFlagBits stage, const RID& rid) {
+    pipeline->modules.emplace_back(stage, shaderModule(rid));
+    pipeline->moduleKeys.emplace_back(m_resources.contains(rid) ? reinterpret_cast<ShaderHandle *>(m_resources.at(rid))->key : 0);
+  };
+
+  if (pipeline->bindPoint == vk::PipelineBindPoint::eCompute) {
+    resolve(vk::ShaderStageFlagBits::eCompute, pipeline->compute);
+    return;
+  }
+
+  const GraphicsPipelineShaders& shaders = pipeline->shaders;
+  resolve(vk::ShaderStageFlagBits::eVertex, shaders.vertex);
+  resolve(vk::ShaderStageFlagBits::eFragment, shaders.fragment);
+
+  if (shaders.tesselation_control.is_valid() && m_context->supportsTesselation()) {
+    resolve(vk::ShaderStageFlagBits::eTessellationControl, shaders.tesselation_control);
+    resolve(vk::ShaderStageFlagBits::eTessellationEvaluation, shaders.tesselation_evaluation);
+  }
+}
+
+bool Engine::reflectPipeline(const PipelineHandle * pipeline, ShaderReflection& reflection) const {
+  std::vector<RID> stages = { pipeline->compute };
+  if (pipeline->bindPoint == vk::PipelineBindPoint::eGraphics) {
+    stages = { pipeline->shaders.vertex, pipeline->shaders.fragment };
+    if (pipeline->shaders.tesselation_control.is_valid() && m_context->supportsTesselation()) {
+      stages.emplace_back(pipeline->shaders.tesselation_control);
+      stages.emplace_back(pipeline->shaders.tesselation_evaluation);
+    }
+  }
+
+  for (const auto& stage : stages) {
+    const ShaderHandle * shader = reinterpret_cast<const ShaderHandle *>(m_resources.at(stage));
+    if (!mergeReflection(reflection, shader->reflection)) {
+      Log::warn(std::format("{} declares a binding with a different type than another stage", shader->path));
+      return false;
+    }
+  }
+
+  unsigned int maxSize = m_context->gpu().getProperties().limits.maxPushConstantsSize;
+  if (reflection.pushConstantSize > maxSize) {
+    Log::warn(std::format("shader push constants use {} bytes but the GPU supports {}", reflection.pushConstantSize, maxSize));
+    return false;
+  }
+
+  reflection.pushConstantSize = (reflection.pushConstantSize + 3) & ~3u;
+  return true;
+}
+
+bool Engine::validateSpecialization(const SpecializationConstants& constants, const ShaderReflection& reflection) const {
+  bool valid = true;
+
+  for (const auto& [id, value] : constants.values) {
+    auto it = reflection.specializationConstants.find(id);
+    if (it == reflection.specializationConstants.end()) {
+      Log::warn(std::format("specialization constant {} is not declared by the pipeline's shaders and will be ignored", id));
+      continue;
+    }
+
+    if (it->second != value.size()) {
+      Log::warn(std::format("specialization constant {} is {} bytes but the shader declares {}", id, value.size(), it->second));
+      valid = false;
+    }
+  }
+
+  return valid;
+}
+
+bool Engine::validateBindings(const std::vector<std::vector<vk::DescriptorSetLayoutBinding>>& sets, const ShaderReflection& reflection) const {
+  bool valid = true;
+
+  for (const auto& reflected : reflection.bindings) {
+    if (reflected.set >= sets.size()) {
+      Log::warn(std::format("shader uses descriptor set {} but only {} sets are bound", reflected.set, sets.size()));
+      valid = false;
+      continue;
+    }
+
+    const auto& bindings = sets[reflected.set];
+    auto it = std::find_if(bindings.begin(), bindings.end(), [&reflected](const auto& binding) {
+      return binding.binding == reflected.binding;
+    });
+
+    if (it == bindings.end()) {
+      Log::warn(std::format("shader expects binding {} in set {} but the descriptor set does not provide it", reflected.binding, reflected.set));
+      valid = false;
+    }
+    else if (it->descriptorType != reflected.type) {
+      Log::warn(std::format(
+        "shader expects {} at binding {} but the descriptor set provides {}",
+        vk::to_string(reflected.type), reflected.binding, vk::to_string(it->descriptorType)
+      ));
+      valid = false;
+    }
+    else if (reflected.count > it->descriptorCount) {
+      Log::warn(std::format(
+        "shader expects {} descriptors at binding {} but the descriptor set provides {}",
+        reflected.count, reflected.binding, it->descriptorCount
+      ));
+      valid = false;
+    }
+  }
+
+  return valid;
+}
+
+vk::DescriptorSetLayout Engine::acquireSetLayout(const std::vector<vk::DescriptorSetLayoutBinding>& bindings, unsigned long& key, bool push) {
+  vk::DescriptorSetLayoutCreateFlags flags;
+  if (push) flags |= vk::DescriptorSetLayoutCreateFlagBits::ePushDescriptorKHR;
+  if (m_descriptorBuffer) flags |= vk::DescriptorSetLayoutCreateFlagBits::eDescriptorBufferEXT;
+
+  key = fnv1aValue(static_cast<VkDescriptorSetLayoutCreateFlags>(flags));
+  for (const auto& binding : bindings) {
+    key = fnv1aValue(binding.binding, key);
+    key = fnv1aValue(binding.descriptorType, key);
+    key = fnv1aValue(binding.descriptorCount, key);
+    key = fnv1aValue(static_cast<VkShaderStageFlags>(binding.stageFlags), key);
+  }
+
+  if (auto it = m_setLayouts.find(key); it != m_setLayouts.end()) {
+    ++it->second.second;
+    return reinterpret_cast<VkDescriptorSetLayout>(it->second.first);
+  }
+
+  vk::DescriptorSetLayout layout = m_context->device().createDescriptorSetLayout(vk::DescriptorSetLayoutCreateInfo{
+    .flags        = flags,
+    .bindingCount = static_cast<unsigned int>(bindings.size()),
+    .pBindings    = bindings.data()
+  });
+
+  m_setLayouts[key] = { reinterpret_cast<unsigned long>(static_cast<VkDescriptorSetLayout>(layout)), 1 };
+  return layout;
+}
+
+void Engine::registerBindless(const RID& rid) {
+  if (!m_bindless) return;
+
+  unsigned int index = m_bindless->acquire();
+  if (index == 0) {
+    Log::warn("bindless descriptor set is full. resource will not be added to it");
+    return;
+  }
+
+  m_bindlessIndices[rid] = index;
+
+  if (rid.m_type == ResourceType::StorageBuffer) {
+    m_bindless->write(m_context->device(), index, vk::DescriptorBufferInfo{
+      .buffer = reinterpret_cast<VkBuffer>(m_resources.at(rid)),
+      .range  = vk::WholeSize
+    });
+    return;
+  }
+
+  ImageHandle * image = reinterpret_cast<ImageHandle *>(m_resources.at(rid));
+
+  if (rid.m_type != ResourceType::Texture) {
+    m_bindless->write(m_context->device(), BindlessHeap::storageImageBinding, index, vk::DescriptorImageInfo{
+      .imageView    = image->view,
+      .imageLayout  = vk::ImageLayout::eGeneral
+    });
+  }
+
+  if (rid.m_type != ResourceType::StorageImage) {
+    m_bindless->write(m_context->device(), BindlessHeap::textureBinding, index, vk::DescriptorImageInfo{
+      .sampler      = reinterpret_cast<VkSampler>(m_resources.at(image->sampler)),
+      .imageView    = image->view,
+      .imageLayout  = vk::ImageLayout::eShaderReadOnlyOptimal
+    });
+  }
+}
+
+void Engine::releaseBindless(const RID& rid) {
+  auto it = m_bindlessIndices.find(rid);
+  if (it == m_bindlessIndices.end()) return;
+
+  deferDeletion([this, index = it->second] { m_bindless->release(index); });
+  m_bindlessIndices.erase(it);
+}
+
+void Engine::retainSetLayout(unsigned long key) {
+  if (auto it = m_setLayouts.find(key); it != m_setLayouts.end())
+    ++it->second.second;
+}
+
+void Engine::releaseSetLayout(unsigned long key) {
+  auto it = m_setLayouts.find(key);
+  if (it == m_setLayouts.end() || --it->second.second > 0) return;
+
+  m_context->device().destroyDescriptorSetLayout(reinterpret_cast<VkDescriptorSetLayout>(it->second.first));
+  m_setLayouts.erase(it);
+}
+
+vk::PipelineLayout Engine::acquirePipelineLayout(const std::vector<vk::DescriptorSetLayout>& setLayouts, const std::vector<unsigned long>& setLayoutKeys, const ShaderReflection& reflection, vk::PushConstantRange& range, unsigned long& key) {
+  range = vk::PushConstantRange{
+    .stageFlags = reflection.pushConstantStages,
+    .size       = reflection.pushConstantSize
+  };
+
+  if (m_bindless && !setLayouts.empty() && setLayouts[0] == m_bindless->layout() && reflection.pushConstantSize <= BindlessHeap::pushConstantSize) {
+    range = vk::PushConstantRange{
+      .stageFlags = vk::ShaderStageFlagBits::eAll,
+      .size       = BindlessHeap::pushConstantSize
+    };
+  }
+
+  key = fnv1aOffset;
+  for (unsigned long setLayoutKey : setLayoutKeys)
+    key = fnv1aValue(setLayoutKey, key);
+  key = fnv1aValue(range.size, key);
+  key = fnv1aValue(static_cast<VkShaderStageFlags>(range.stageFlags), key);
+
+  if (auto it = m_pipelineLayouts.find(key); it != m_pipelineLayouts.end()) {
+    ++it->second.second;
+    return reinterpret_cast<VkPipelineLayout>(it->second.first);
+  }
+
+  vk::PipelineLayout layout = m_context->device().createPipelineLayout(vk::PipelineLayoutCreateInfo{
+    .setLayoutCount         = static_cast<unsigned int>(setLayouts.size()),
+    .pSetLayouts            = setLayouts.data(),
+    .pushConstantRangeCount = range.size > 0 ? 1u : 0u,
+    .pPushConstantRanges    = &range
+  });
+
+  m_pipelineLayouts[key] = { reinterpret_cast<unsigned long>(static_cast<VkPipelineLayout>(layout)), 1 };
+  return layout;
+}
+
+void Engine::releasePipelineLayout(unsigned long key) {
+  auto it = m_pipelineLayouts.find(key);
+  if (it == m_pipelineLayouts.end() || --it->second.second > 0) return;
 
-  double time = std::chrono::duration(now - start).count();
+  m_context->device().destroyPipelineLayout(reinterpret_cast<VkPipelineLayout>(it->second.first));
+  m_pipelineLayouts.erase(it);
+}
 
-  m_frameTime = std::min(time - m_time, 0.25);
-  m_time = time;
+void Engine::reloadShaders() {
+  if (!m_shaderWatcher || !m_pendingPipelines.empty() || !m_optimizingPipelines.empty()) return;
+
+  for (const auto& file : m_shaderWatcher->changed()) {
+    for (const auto& [rid, handle] : m_resources) {
+      if (rid.m_type != ResourceType::Shader) continue;
+
+      ShaderHandle * shader = reinterpret_cast<ShaderHandle *>(handle);
+      bool dependent = false;
+      std::error_code error;
+      for (const auto& source : shader->includes)
+        dependent |= std::filesystem::weakly_canonical(source, error) == file;
+      dependent |= std::filesystem::weakly_canonical(shader->path, error) == file;
+      if (!dependent) continue;
+
+      m_shaderReloads.emplace_back(rid, m_workers->submit([this, type = shader->type, path = shader->path, defines = shader->defines, precompiled = shader->precompiled] {
+        using Result = std::tuple<unsigned long, std::vector<unsigned int>, std::vector<std::string>>;
+
+        if (precompiled) {
+          std::vector<unsigned int> code = readSpirv(path);
+          return code.empty() ? Result() : Result(spirvKey(type, code), std::move(code), std::vector<std::string>());
+        }
+
+#ifndef GROOT_SHADER_COMPILER
+        return Result();
+#else
+        std::string source = m_compiler->readSource(path);
+        if (source.empty()) return Result();
+
+        PreprocessedShader preprocessed = m_compiler->preprocess(type, path, source, defines);
+        if (preprocessed.source.empty()) return Result();
+
+        unsigned long key = m_compiler->cacheKey(type, preprocessed.source);
+        return Result(key, m_compiler->compileShader(type, path, preprocessed.source, key), std::move(preprocessed.includes));
+#endif
+      }));
+    }
+  }
+
+  std::set<RID> reloaded;
+  std::erase_if(m_shaderReloads, [this, &reloaded](auto& reload) {
+    auto& [rid, future] = reload;
+    if (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return false;
+
+    auto [key, code, includes] = future.get();
+    if (!m_resources.contains(rid)) return true;
+
+    ShaderHandle * shader = reinterpret_cast<ShaderHandle *>(m_resources.at(rid));
+    if (code.empty()) {
+      Log::warn(std::format("failed to reload {}. keeping the previous shader", shader->path));
+      return true;
+    }
+
+    for (const auto& include : includes)
+      m_shaderWatcher->watch(include);
+    shader->includes = std::move(includes);
+
+    if (key == shader->key) return true;
+
+    vk::ShaderModule old = shader->module;
+    deferDeletion([this, old] { m_context->device().destroyShaderModule(old); });
+
+    shader->module = m_context->device().createShaderModule(vk::ShaderModuleCreateInfo{
+      .codeSize = code.size() * sizeof(unsigned int),
+      .pCode    = code.data()
+    });
+    shader->reflection = reflectShader(code);
+
+    if (auto it = m_shaderCache.find(shader->key); it != m_shaderCache.end() && it->second == rid)
+      m_shaderCache.erase(it);
+    m_shaderCache.try_emplace(key, rid);
+    shader->key = key;
+
+    Log::generic(std::format("reloaded {}", shader->path));
+    reloaded.emplace(rid);
+
+    return true;
+  });
+
+  if (reloaded.empty()) return;
+
+  for (const auto& [rid, handle] : m_resources) {
+    if (rid.m_type != ResourceType::Pipeline) continue;
+
+    PipelineHandle * pipeline = reinterpret_cast<PipelineHandle *>(handle);
+    bool dependent = pipeline->bindPoint == vk::PipelineBindPoint::eCompute
+      ? reloaded.contains(pipeline->compute)
+      : reloaded.contains(pipeline->shaders.vertex) ||
+        reloaded.contains(pipeline->shaders.fragment) ||
+        reloaded.contains(pipeline->shaders.tesselation_control) ||
+        reloaded.contains(pipeline->shaders.tesselation_evaluation);
+    if (!dependent || pipeline->pending.valid()) continue;
+
+    ShaderReflection reflection;
+    bool compatible = reflectPipeline(pipeline, reflection) && validateBindings(pipeline->bindings, reflection);
+    compatible &= reflection.pushConstantSize <= pipeline->reflection.pushConstantSize;
+    compatible &= !(reflection.pushConstantStages & ~pipeline->reflection.pushConstantStages);
+    if (!compatible) {
+      Log::warn("reloaded shaders no longer match the pipeline layout. keeping the previous pipeline");
+      continue;
+    }
+
+    std::vector<std::pair<unsigned long, vk::Pipeline>> libraries = std::move(pipeline->libraries);
+    resolveModules(pipeline);
+    vk::Pipeline rebuilt = buildPipeline(pipeline);
+    if (!rebuilt) {
+      Log::warn("failed to rebuild pipeline after shader reload. keeping the previous pipeline");
+      pipeline->libraries = std::move(libraries);
+      continue;
+    }
+
+    std::swap(pipeline->libraries, libraries);
+    releasePipelineLibraries(pipeline);
+    pipeline->libraries = std::move(libraries);
+
+    vk::Pipeline old = pipeline->pipeline;
+    deferDeletion([this, old] { m_context->device().destroyPipeline(old); });
+    pipeline->pipeline = rebuilt;
+    optimizePipeline(rid);
+  }
+}
+
+void Engine::refreshDescriptorSets() {
+  unsigned int frame = m_renderer->frameIndex();
+
+  std::erase_if(m_staleSets, [this, frame](const RID& rid) {
+    DescriptorSetHandle * set = reinterpret_cast<DescriptorSetHandle *>(m_resources.at(rid));
+    if (set->stale & (1u << frame)) {
+      rewriteDescriptors(set->copies[frame], set);
+      set->stale &= ~(1u << frame);
+    }
+
+    return set->stale == 0;
+  });
+}
+
+void Engine::deferDeletion(std::function<void()>&& deletion) {
+  m_deletionQueue.emplace_back(m_frameCount + m_settings.flight_frames, std::move(deletion));
+}
+
+void Engine::flushDeletions(bool all) {
+  std::erase_if(m_deletionQueue, [this, all](auto& entry) {
+    if (!all && entry.first > m_frameCount) return false;
+
+    entry.second();
+    return true;
+  });
+}
+
+std::vector<unsigned int> Engine::readSpirv(const std::string& path) const {
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  if (!file) {
+    Log::warn(std::format("{} not found", path));
+    return {};
+  }
+
+  std::size_t size = file.tellg();
+  std::vector<unsigned int> code(size / sizeof(unsigned int));
+  file.seekg(0);
+
+  if (size == 0 || size % sizeof(unsigned int) != 0 || !file.read(reinterpret_cast<char *>(code.data()), size) || code[0] != 0x07230203) {
+    Log::warn(std::format("{} is not a valid SPIR-V binary", path));
+    return {};
+  }
+
+  return code;
+}
+
+unsigned long Engine::spirvKey(ShaderType type, const std::vector<unsigned int>& code) const {
+  return fnv1aValue(type, fnv1a(code.data(), code.size() * sizeof(unsigned int)));
+}
+
+RID Engine::createShader(
+  ShaderType type,
+  const std::string& path,
+  const std::vector<ShaderDefine>& defines,
+  const std::vector<std::string>& includes,
+  unsigned long key,
+  const std::vector<unsigned int>& code,
+  bool precompiled
+) {
+  if (code.empty()) return RID();
+
+  vk::ShaderModuleCreateInfo createInfo{
+    .codeSize = code.size() * sizeof(unsigned int),
+    .pCode = code.data()
+  };
+
+  ShaderHandle * shader = new ShaderHandle;
+  shader->module = m_context->device().createShaderModule(createInfo);
+  shader->type = type;
+  shader->path = path;
+  shader->defines = defines;
+  shader->includes = includes;
+  shader->key = key;
+  shader->reflection = reflectShader(code);
+
+  if (!path.empty())
+    Log::generic(std::format("{} {}", precompiled ? "loaded" : "compiled", path));
+
+  if (m_shaderWatcher && !path.empty()) {
+    m_shaderWatcher->watch(path);
+    for (const auto& include : includes)
+      m_shaderWatcher->watch(include);
+  }
+
+  RID rid = RID(m_nextRID++, ResourceType::Shader);
+  m_resources[rid] = reinterpret_cast<unsigned long>(shader);
+  m_shaderCache[key] = rid;
+  m_refCounts[rid] = 1;
+
+  return rid;
+}
+
+RID Engine::createStorageImage(unsigned int width, unsigned int height, unsigned int depth, ImageType type, Format format, const RID& sampler) {
+  bool volume = type == ImageType::three_dim;
+  unsigned int layers = volume ? 1 : depth;
+
+  vk::ImageType imageType = vk::ImageType::e2D;
+  if (type == ImageType::one_dim || type == ImageType::one_dim_array)
+    imageType = vk::ImageType::e1D;
+  else if (volume)
+    imageType = vk::ImageType::e3D;
+
+  vk::ImageCreateFlags flags;
+  if (type == ImageType::cube || type == ImageType::cube_array)
+    flags |= vk::ImageCreateFlagBits::eCubeCompatible;
+
+  vk::ImageUsageFlags usage = vk::ImageUsageFlagBits::eStorage | vk::ImageUsageFlagBits::eTransferSrc | vk::ImageUsageFlagBits::eTransferDst;
+  if (sampler.is_valid())
+    usage |= vk::ImageUsageFlagBits::eSampled;
+
+  vk::ImageCreateInfo imageCreateInfo{
+    .flags        = flags,
+    .imageType    = imageType,
+    .format       = static_cast<vk::Format>(format),
+    .extent       = vk::Extent3D{ width, height, volume ? depth : 1 },
+    .mipLevels    = 1,
+    .arrayLayers  = layers,
+    .samples      = vk::SampleCountFlagBits::e1,
+    .tiling       = vk::ImageTiling::eOptimal,
+    .usage        = usage,
+  };
+
+  vk::Image image = m_allocator->allocateImage(imageCreateInfo);
+
+  std::vector<vk::CommandBuffer> cmds = m_context->transferCmds(1);
+  vk::CommandBuffer& cmd = cmds[0];
+  cmd.begin(vk::CommandBufferBeginInfo{ .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+
+  vk::ImageMemoryBarrier shaderBarrier{
+    .oldLayout        = vk::ImageLayout::eUndefined,
+    .newLayout        = sampler.is_valid() ? vk::ImageLayout::eShaderReadOnlyOptimal : vk::ImageLayout::eGeneral,
+    .image            = image,
+    .subresourceRange = {
+      .aspectMask = vk::ImageAspectFlagBits::eColor,
+      .levelCount = 1,
+      .layerCount = layers
+    }
+  };
+
+  cmd.pipelineBarrier(
+    vk::PipelineStageFlagBits::eTopOfPipe,
+    vk::PipelineStageFlagBits::eTopOfPipe,
+    vk::DependencyFlags(),
+    nullptr,
+    nullptr,
+    shaderBarrier
+  );
+
+  cmd.end();
+
+  vk::Fence fence = m_context->device().createFence({});
+
+  auto [index, queue] = m_context->transferQueue();
+  queue.submit(vk::SubmitInfo{
+    .commandBufferCount = 1,
+    .pCommandBuffers    = &cmd,
+  }, fence);
+
+  vk::ImageViewCreateInfo viewCreateInfo{
+    .image    = image,
+    .viewType = static_cast<vk::ImageViewType>(type),
+    .format   = static_cast<vk::Format>(format),
+    .components = {
+      .r = vk::ComponentSwizzle::eIdentity,
+      .g = vk::ComponentSwizzle::eIdentity,
+      .b = vk::ComponentSwizzle::eIdentity,
+      .a = vk::ComponentSwizzle::eIdentity
+    },
+    .subresourceRange = {
+      .aspectMask = vk::ImageAspectFlagBits::eColor,
+      .levelCount = 1,
+      .layerCount = layers
+    }
+  };
+
+  vk::ImageView view = m_context->device().createImageView(viewCreateInfo);
+
+  ImageHandle * handle = new ImageHandle;
+  handle->image = image;
+  handle->view = view;
+  handle->sampler = sampler;
+  handle->format = imageCreateInfo.format;
+  handle->extent = imageCreateInfo.extent;
+  handle->layers = layers;
+
+  RID rid(m_nextRID++, sampler.is_valid() ? ResourceType::StorageTexture : ResourceType::StorageImage);
+  m_resources[rid] = reinterpret_cast<unsigned long>(handle);
+  registerBindless(rid);
+
+  if (sampler.is_valid()) {
+    m_busySamplers.emplace(sampler);
+    m_storageTextures.emplace(reinterpret_cast<unsigned long>(static_cast<VkImage>(image)));
+  }
+
+  if (m_context->device().waitForFences(fence, true, 1000000000) != vk::Result::eSuccess)
+    Log::runtime_error("Hung waiting for storage image transition");
+
+  m_context->device().destroyFence(fence);
+  m_context->destroyTransferCmds(cmds);
+
+  return rid;
+}
+
+unsigned int Engine::defaultLayers(ImageType type) const {
+  if (type == ImageType::cube || type == ImageType::cube_array) return 6;
+  return 1;
+}
+
+bool Engine::validImageDimensions(unsigned int width, unsigned int height, unsigned int depth, ImageType type) const {
+  const vk::PhysicalDeviceLimits limits = m_context->gpu().getProperties().limits;
+
+  if (depth == 0) {
+    Log::warn("tried to create image with 0 depth or layers");
+    return false;
+  }
+
+  switch (type) {
+    case ImageType::one_dim:
+    case ImageType::one_dim_array:
+      if (height != 1) {
+        Log::warn("tried to create 1D image with height other than 1");
+        return false;
+      }
+      if (width > limits.maxImageDimension1D) {
+        Log::warn("tried to create 1D image larger than the device limit");
+        return false;
+      }
+      break;
+    case ImageType::two_dim:
+    case ImageType::two_dim_array:
+      if (width > limits.maxImageDimension2D || height > limits.maxImageDimension2D) {
+        Log::warn("tried to create 2D image larger than the device limit");
+        return false;
+      }
+      break;
+    case ImageType::three_dim:
+      if (width > limits.maxImageDimension3D || height > limits.maxImageDimension3D || depth > limits.maxImageDimension3D) {
+        Log::warn("tried to create 3D image larger than the device limit");
+        return false;
+      }
+      return true;
+    case ImageType::cube:
+    case ImageType::cube_array:
+      if (width != height) {
+        Log::warn("tried to create cube image with non-square faces");
+        return false;
+      }
+      if (width > limits.maxImageDimensionCube) {
+        Log::warn("tried to create cube image larger than the device limit");
+        return false;
+      }
+      if (type == ImageType::cube ? depth != 6 : depth % 6 != 0) {
+        Log::warn("tried to create cube image with a face count other than a multiple of 6");
+        return false;
+      }
+      break;
+  }
+
+  if ((type == ImageType::one_dim || type == ImageType::two_dim) && depth != 1) {
+    Log::warn("tried to create non-array image with more than 1 layer");
+    return false;
+  }
+
+  if (depth > limits.maxImageArrayLayers) {
+    Log::warn("tried to create image with more layers than the device limit");
+    return false;
+  }
+
+  return true;
 }
 
 std::pair<unsigned int, void *> Engine::readBufferRaw(const RID& rid) const {
@@ -1698,4 +3423,117 @@ void Engine::writeBufferRaw(const RID& rid, std::size_t size, const void * data)
   m_allocator->unmapBuffer(buffer);
 }
 
-} // namespace groot
\ No newline at end of file
+void Engine::writeImageRaw(const RID& rid, std::size_t size, const void * data, unsigned int layer) const {
+  if (!rid.is_valid()) {
+    Log::warn("tried to write to invalid image RID");
+    return;
+  }
+
+  if (rid.m_type != ResourceType::StorageImage && rid.m_type != ResourceType::StorageTexture && rid.m_type != ResourceType::Texture) {
+    Log::warn("tried to write image data to non-image RID");
+    return;
+  }
+
+  ImageHandle * handle = reinterpret_cast<ImageHandle *>(m_resources.at(rid));
+
+  bool volume = handle->extent.depth > 1;
+  std::size_t sliceSize = static_cast<std::size_t>(handle->extent.width) * handle->extent.height * vk::blockSize(handle->format);
+  unsigned int slices = volume ? handle->extent.depth : handle->layers;
+
+  if (size == 0 || size % sliceSize != 0) {
+    Log::warn("tried to write image data that is not a whole number of layers");
+    return;
+  }
+
+  unsigned int count = static_cast<unsigned int>(size / sliceSize);
+  if (layer + count > slices) {
+    Log::warn("tried to write past the last layer of an image");
+    return;
+  }
+
+  vk::Buffer buffer = m_allocator->allocateBuffer(vk::BufferCreateInfo{
+    .size   = size,
+    .usage  = vk::BufferUsageFlagBits::eTransferSrc
+  });
+
+  void * map = m_allocator->mapBuffer(buffer);
+  std::memcpy(map, data, size);
+  m_allocator->unmapBuffer(buffer);
+
+  vk::ImageLayout restLayout = rid.m_type == ResourceType::StorageImage ? vk::ImageLayout::eGeneral : vk::ImageLayout::eShaderReadOnlyOptimal;
+  vk::ImageSubresourceRange range{
+    .aspectMask     = vk::ImageAspectFlagBits::eColor,
+    .levelCount     = 1,
+    .baseArrayLayer = volume ? 0 : layer,
+    .layerCount     = volume ? 1 : count
+  };
+
+  std::vector<vk::CommandBuffer> cmds = m_context->transferCmds(1);
+  vk::CommandBuffer& cmd = cmds[0];
+  cmd.begin(vk::CommandBufferBeginInfo{ .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+
+  vk::ImageMemoryBarrier copyBarrier{
+    .srcAccessMask    = vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite,
+    .dstAccessMask    = vk::AccessFlagBits::eTransferWrite,
+    .oldLayout        = restLayout,
+    .newLayout        = vk::ImageLayout::eTransferDstOptimal,
+    .image            = handle->image,
+    .subresourceRange = range
+  };
+
+  cmd.pipelineBarrier(
+    vk::PipelineStageFlagBits::eAllCommands,
+    vk::PipelineStageFlagBits::eTransfer,
+    vk::DependencyFlags(),
+    nullptr,
+    nullptr,
+    copyBarrier
+  );
+
+  cmd.copyBufferToImage(buffer, handle->image, vk::ImageLayout::eTransferDstOptimal, vk::BufferImageCopy{
+    .imageSubresource = {
+      .aspectMask     = vk::ImageAspectFlagBits::eColor,
+      .baseArrayLayer = range.baseArrayLayer,
+      .layerCount     = range.layerCount
+    },
+    .imageOffset = { 0, 0, volume ? static_cast<int>(layer) : 0 },
+    .imageExtent = { handle->extent.width, handle->extent.height, volume ? count : 1 }
+  });
+
+  vk::ImageMemoryBarrier shaderBarrier{
+    .srcAccessMask    = vk::AccessFlagBits::eTransferWrite,
+    .dstAccessMask    = vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite,
+    .oldLayout        = vk::ImageLayout::eTransferDstOptimal,
+    .newLayout        = restLayout,
+    .image            = handle->image,
+    .subresourceRange = range
+  };
+
+  cmd.pipelineBarrier(
+    vk::PipelineStageFlagBits::eTransfer,
+    vk::PipelineStageFlagBits::eAllCommands,
+    vk::DependencyFlags(),
+    nullptr,
+    nullptr,
+    shaderBarrier
+  );
+
+  cmd.end();
+
+  vk::Fence fence = m_context->device().createFence({});
+
+  auto [index, queue] = m_context->transferQueue();
+  queue.submit(vk::SubmitInfo{
+    .commandBufferCount = 1,
+    .pCommandBuffers    = &cmd
+  }, fence);
+
+  if (m_context->device().waitForFences(fence, true, 1000000000) != vk::Result::eSuccess)
+    Log::runtime_error("Hung waiting for image upload");
+
+  m_allocator->destroyBuffer(buffer);
+  m_context->device().destroyFence(fence);
+  m_context->destroyTransferCmds(cmds);
+}
+
+} // namespace groot
@@ -0,0 +1,264 @@
+#include "src/include/frame_capture.hpp"
+#include "src/include/log.hpp"
+
+#include <array>
+#include <filesystem>
+#include <format>
+#include <fstream>
+
+namespace groot {
+
+namespace {
+
+void appendU32(std::vector<unsigned char>& out, unsigned int value) {
+  out.push_back(static_cast<unsigned char>(value >> 24));
+  out.push_back(static_cast<unsigned char>(value >> 16));
+  out.push_back(static_cast<unsigned char>(value >> 8));
+  out.push_back(static_cast<unsigned char>(value));
+}
+
+unsigned int crc32(const unsigned char * data, std::size_t size, unsigned int crc = 0xFFFFFFFF) {
+  static const std::array<unsigned int, 256> table = [] {
+    std::array<unsigned int, 256> table{};
+    for (unsigned int i = 0; i < 256; ++i) {
+      unsigned int c = i;
+      for (unsigned int k = 0; k < 8; ++k)
+        c = c & 1 ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+      table[i] = c;
+    }
+    return table;
+  }();
+
+  for (std::size_t i = 0; i < size; ++i)
+    crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+
+  return crc;
+}
+
+void appendChunk(std::vector<unsigned char>& out, const char * type, const std::vector<unsigned char>& data) {
+  appendU32(out, data.size());
+
+  std::size_t start = out.size();
+  out.insert(out.end(), type, type + 4);
+  out.insert(out.end(), data.begin(), data.end());
+
+  appendU32(out, crc32(out.data() + start, out.size() - start) ^ 0xFFFFFFFF);
+}
+
+} // namespace
+
+std::vector<unsigned char> encodePNG(unsigned int width, unsigned int height, const std::vector<unsigned char>& pixels) {
+  std::vector<unsigned char> out = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+
+  std::vector<unsigned char> header;
+  appendU32(header, width);
+  appendU32(header, height);
+  header.insert(header.end(), { 8, 6, 0, 0, 0 });
+  appendChunk(out, "IHDR", header);
+
+  std::size_t stride = static_cast<std::size_t>(width) * 4;
+  std::vector<unsigned char> scanlines;
+  scanlines.reserve((stride + 1) * height);
+  for (unsigned int y = 0; y < height; ++y) {
+    scanlines.push_back(0);
+    scanlines.insert(scanlines.end(), pixels.begin() + y * stride, pixels.begin() + (y + 1) * stride);
+  }
+
+  std::vector<unsigned char> zlib = { 0x78, 0x01 };
+  zlib.reserve(scanlines.size() + scanlines.size() / 65535 * 5 + 16);
+
+  std::size_t offset = 0;
+  do {
+    std::size_t block = std::min<std::size_t>(scanlines.size() - offset, 65535);
+    bool last = offset + block == scanlines.size();
+
+    zlib.push_back(last ? 1 : 0);
+    zlib.push_back(static_cast<unsigned char>(block));
+    zlib.push_back(static_cast<unsigned char>(block >> 8));
+    zlib.push_back(static_cast<unsigned char>(~block));
+    zlib.push_back(static_cast<unsigned char>(~block >> 8));
+    zlib.insert(zlib.end(), scanlines.begin() + offset, scanlines.begin() + offset + block);
+
+    offset += block;
+  } while (offset < scanlines.size());
+
+  unsigned int a = 1, b = 0;
+  for (unsigned char byte : scanlines) {
+    a = (a + byte) % 65521;
+    b = (b + a) % 65521;
+  }
+  appendU32(zlib, (b << 16) | a);
+
+  appendChunk(out, "IDAT", zlib);
+  appendChunk(out, "IEND", {});
+
+  return out;
+}
+
+std::vector<unsigned char> encodeQOI(unsigned int width, unsigned int height, const std::vector<unsigned char>& pixels) {
+  std::vector<unsigned char> out = { 'q', 'o', 'i', 'f' };
+  appendU32(out, width);
+  appendU32(out, height);
+  out.push_back(4);
+  out.push_back(0);
+
+  std::array<std::array<unsigned char, 4>, 64> seen{};
+  std::array<unsigned char, 4> prev = { 0, 0, 0, 255 };
+  unsigned int run = 0;
+
+  std::size_t count = static_cast<std::size_t>(width) * height;
+  for (std::size_t i = 0; i < count; ++i) {
+    std::array<unsigned char, 4> px = { pixels[i * 4], pixels[i * 4 + 1], pixels[i * 4 + 2], pixels[i * 4 + 3] };
+
+    if (px == prev) {
+      ++run;
+      if (run == 62 || i + 1 == count) {
+        out.push_back(0xC0 | (run - 1));
+        run = 0;
+      }
+      continue;
+    }
+
+    if (run > 0) {
+      out.push_back(0xC0 | (run - 1));
+      run = 0;
+    }
+
+    unsigned int hash = (px[0] * 3 + px[1] * 5 + px[2] * 7 + px[3] * 11) % 64;
+    if (seen[hash] == px) {
+      out.push_back(hash);
+    }
+    else {
+      seen[hash] = px;
+
+      if (px[3] == prev[3]) {
+        signed char dr = px[0] - prev[0];
+        signed char dg = px[1] - prev[1];
+        signed char db = px[2] - prev[2];
+        signed char drg = dr - dg;
+        signed char dbg = db - dg;
+
+        if (dr > -3 && dr < 2 && dg > -3 && dg < 2 && db > -3 && db < 2)
+          out.push_back(0x40 | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2));
+        else if (drg > -9 && drg < 8 && dg > -33 && dg < 32 && dbg > -9 && dbg < 8) {
+          out.push_back(0x80 | (dg + 32));
+          out.push_back((drg + 8) << 4 | (dbg + 8));
+        }
+        else
+          out.insert(out.end(), { 0xFE, px[0], px[1], px[2] });
+      }
+      else
+        out.insert(out.end(), { 0xFF, px[0], px[1], px[2], px[3] });
+    }
+
+    prev = px;
+  }
+
+  out.insert(out.end(), { 0, 0, 0, 0, 0, 0, 0, 1 });
+  return out;
+}
+
+FrameCapture::FrameCapture(const CaptureSettings& settings, unsigned int width, unsigned int height, bool bgra)
+: m_settings(settings), m_width(width), m_height(height), m_bgra(bgra) {
+  m_settings.max_queued_frames = std::max(m_settings.max_queued_frames, 1u);
+
+  std::error_code error;
+  std::filesystem::create_directories(m_settings.directory, error);
+  if (error)
+    Log::warn(std::format("failed to create capture directory {}: {}", m_settings.directory, error.message()));
+
+  m_worker = std::thread(&FrameCapture::work, this);
+}
+
+FrameCapture::~FrameCapture() {
+  for (auto& readback : m_readbacks) {
+    if (readback.valid())
+      push(Frame{ m_nextFrame++, readback.get() });
+  }
+
+  {
+    std::lock_guard lock(m_mutex);
+    m_stop = true;
+  }
+  m_queueReady.notify_one();
+
+  m_worker.join();
+}
+
+void FrameCapture::track(std::future<std::vector<unsigned char>>&& readback) {
+  m_readbacks.emplace_back(std::move(readback));
+}
+
+void FrameCapture::collect() {
+  while (!m_readbacks.empty()) {
+    std::future<std::vector<unsigned char>>& readback = m_readbacks.front();
+    if (readback.valid()) {
+      if (readback.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return;
+      push(Frame{ m_nextFrame, readback.get() });
+    }
+
+    ++m_nextFrame;
+    m_readbacks.pop_front();
+  }
+}
+
+void FrameCapture::push(Frame&& frame) {
+  std::unique_lock lock(m_mutex);
+  m_queueSpace.wait(lock, [this] { return m_queue.size() < m_settings.max_queued_frames; });
+
+  m_queue.emplace_back(std::move(frame));
+  lock.unlock();
+
+  m_queueReady.notify_one();
+}
+
+void FrameCapture::work() {
+  while (true) {
+    std::unique_lock lock(m_mutex);
+    m_queueReady.wait(lock, [this] { return m_stop || !m_queue.empty(); });
+    if (m_queue.empty()) return;
+
+    Frame frame = std::move(m_queue.front());
+    m_queue.pop_front();
+    lock.unlock();
+
+    m_queueSpace.notify_one();
+
+    write(frame);
+  }
+}
+
+void FrameCapture::write(const Frame& frame) const {
+  std::vector<unsigned char> pixels = frame.pixels;
+  if (m_bgra) {
+    for (std::size_t i = 0; i + 3 < pixels.size(); i += 4)
+      std::swap(pixels[i], pixels[i + 2]);
+  }
+
+  std::vector<unsigned char> encoded;
+  std::string extension = "raw";
+  switch (m_settings.format) {
+    case CaptureFormat::PNG:
+      encoded = encodePNG(m_width, m_height, pixels);
+      extension = "png";
+      break;
+    case CaptureFormat::QOI:
+      encoded = encodeQOI(m_width, m_height, pixels);
+      extension = "qoi";
+      break;
+    default:
+      encoded = std::move(pixels);
+      break;
+  }
+
+  std::string path = std::format("{}/{}_{:06}.{}", m_settings.directory, m_settings.prefix, frame.index, extension);
+  std::ofstream file(path, std::ios::binary);
+  if (!file) {
+    Log::warn(std::format("failed to open {} for frame capture", path));
+    return;
+  }
+
+  file.write(reinterpret_cast<const char *>(encoded.data()), encoded.size());
+}
+
+} // namespace groot
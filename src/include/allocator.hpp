@@ -14,6 +14,7 @@ class VulkanContext;
 class Allocator {
   VmaAllocator m_allocator = nullptr;
   std::unordered_map<VkBuffer, VmaAllocation, VkBufferHash> m_buffers;
+  std::unordered_map<VkBuffer, vk::DeviceSize, VkBufferHash> m_bufferRanges;
   std::unordered_map<VkImage, VmaAllocation, VkImageHash> m_images;
 
   public:
@@ -29,8 +30,11 @@ class Allocator {
     vk::Buffer allocateBuffer(const vk::BufferCreateInfo&, VmaMemoryUsage memoryusage = VMA_MEMORY_USAGE_AUTO, VmaAllocationCreateFlags flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT);
     void * mapBuffer(const vk::Buffer&);
     void unmapBuffer(const vk::Buffer&);
+    void invalidateBuffer(const vk::Buffer&);
+    void flushBuffer(const vk::Buffer&, vk::DeviceSize, vk::DeviceSize);
     void destroyBuffer(const vk::Buffer&);
     unsigned int bufferSize(const vk::Buffer&) const;
+    vk::DeviceSize bufferRange(const vk::Buffer&) const;
 
     vk::Image allocateImage(const vk::ImageCreateInfo&, VmaMemoryUsage memoryUsage = VMA_MEMORY_USAGE_AUTO);
     void destroyImage(const vk::Image&);
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <utility>
+#include <vector>
+
+namespace groot {
+
+struct AtlasLayout {
+  unsigned int width = 0;
+  unsigned int height = 0;
+  std::vector<std::pair<unsigned int, unsigned int>> offsets;
+};
+
+class AtlasPacker {
+  unsigned int m_maxSize = 0;
+  unsigned int m_padding = 0;
+
+  public:
+    explicit AtlasPacker(unsigned int, unsigned int padding = 1);
+    AtlasPacker(const AtlasPacker&) = default;
+    AtlasPacker(AtlasPacker&&) = default;
+
+    ~AtlasPacker() = default;
+
+    AtlasPacker& operator=(const AtlasPacker&) = default;
+    AtlasPacker& operator=(AtlasPacker&&) = default;
+
+    AtlasLayout pack(const std::vector<std::pair<unsigned int, unsigned int>>&) const;
+
+  private:
+    unsigned int shelve(
+      unsigned int,
+      const std::vector<std::pair<unsigned int, unsigned int>>&,
+      const std::vector<unsigned int>&,
+      std::vector<std::pair<unsigned int, unsigned int>>&
+    ) const;
+};
+
+} // namespace groot
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+
+#include <vector>
+
+namespace groot {
+
+class VulkanContext;
+
+class BindlessHeap {
+  vk::DescriptorPool m_pool = nullptr;
+  vk::DescriptorSetLayout m_layout = nullptr;
+  vk::DescriptorSet m_set = nullptr;
+  std::vector<vk::DescriptorSetLayoutBinding> m_bindings;
+
+  unsigned int m_capacity = 0;
+  unsigned int m_next = 1;
+  std::vector<unsigned int> m_free;
+
+  public:
+    static constexpr unsigned int textureBinding = 0;
+    static constexpr unsigned int storageImageBinding = 1;
+    static constexpr unsigned int storageBufferBinding = 2;
+    static constexpr unsigned int pushConstantSize = 128;
+
+    BindlessHeap(const VulkanContext *, unsigned int);
+    BindlessHeap(const BindlessHeap&) = delete;
+    BindlessHeap(BindlessHeap&&) = delete;
+
+    ~BindlessHeap() = default;
+
+    BindlessHeap& operator=(const BindlessHeap&) = delete;
+    BindlessHeap& operator=(BindlessHeap&&) = delete;
+
+    const vk::DescriptorSetLayout& layout() const;
+    const vk::DescriptorSet& set() const;
+    const std::vector<vk::DescriptorSetLayoutBinding>& bindings() const;
+    unsigned int capacity() const;
+
+    unsigned int acquire();
+    void release(unsigned int);
+    void write(const vk::Device&, unsigned int, unsigned int, const vk::DescriptorImageInfo&) const;
+    void write(const vk::Device&, unsigned int, const vk::DescriptorBufferInfo&) const;
+    void destroy(const vk::Device&);
+};
+
+} // namespace groot
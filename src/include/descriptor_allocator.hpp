@@ -0,0 +1,54 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+
+#include <unordered_map>
+#include <vector>
+
+namespace groot {
+
+struct DescriptorAllocation {
+  vk::DescriptorSet set = nullptr;
+  vk::DescriptorPool pool = nullptr;
+  unsigned long poolKey = 0;
+  vk::DeviceSize offset = 0;
+};
+
+class DescriptorAllocator {
+  struct Pool {
+    vk::DescriptorPool pool = nullptr;
+    unsigned int capacity = 0;
+    unsigned int allocated = 0;
+    unsigned int live = 0;
+  };
+
+  struct PoolFamily {
+    std::vector<vk::DescriptorPoolSize> sizes;
+    std::vector<Pool> pools;
+  };
+
+  std::unordered_map<unsigned long, PoolFamily> m_families;
+  unsigned int m_initialSets = 0;
+  unsigned int m_maxSets = 0;
+
+  public:
+    DescriptorAllocator(unsigned int, unsigned int);
+    DescriptorAllocator(const DescriptorAllocator&) = delete;
+    DescriptorAllocator(DescriptorAllocator&&) = delete;
+
+    ~DescriptorAllocator() = default;
+
+    DescriptorAllocator& operator=(const DescriptorAllocator&) = delete;
+    DescriptorAllocator& operator=(DescriptorAllocator&&) = delete;
+
+    DescriptorAllocation allocate(const vk::Device&, const vk::DescriptorSetLayout&, const std::vector<vk::DescriptorSetLayoutBinding>&);
+    void free(const vk::Device&, const DescriptorAllocation&);
+    void destroy(const vk::Device&);
+
+    unsigned int poolCount() const;
+
+  private:
+    Pool& acquire(const vk::Device&, PoolFamily&);
+};
+
+} // namespace groot
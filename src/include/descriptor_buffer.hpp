@@ -0,0 +1,42 @@
+#pragma once
+
+#include "src/include/descriptor_allocator.hpp"
+
+#include <vulkan/vulkan.hpp>
+
+#include <map>
+
+namespace groot {
+
+class Allocator;
+class VulkanContext;
+
+class DescriptorBuffer {
+  vk::Buffer m_buffer = nullptr;
+  unsigned char * m_data = nullptr;
+  vk::DeviceAddress m_address = 0;
+  vk::DeviceSize m_size = 0;
+  vk::DeviceSize m_alignment = 1;
+  std::map<vk::DeviceSize, vk::DeviceSize> m_free;
+  std::map<vk::DeviceSize, vk::DeviceSize> m_allocated;
+
+  public:
+    DescriptorBuffer(const VulkanContext *, Allocator *, vk::DeviceSize);
+    DescriptorBuffer(const DescriptorBuffer&) = delete;
+    DescriptorBuffer(DescriptorBuffer&&) = delete;
+
+    ~DescriptorBuffer() = default;
+
+    DescriptorBuffer& operator=(const DescriptorBuffer&) = delete;
+    DescriptorBuffer& operator=(DescriptorBuffer&&) = delete;
+
+    DescriptorAllocation allocate(const VulkanContext *, const vk::DescriptorSetLayout&);
+    void write(const VulkanContext *, Allocator *, const DescriptorAllocation&, const vk::DescriptorSetLayout&, const vk::WriteDescriptorSet&);
+    void free(const DescriptorAllocation&);
+    void destroy(Allocator *);
+
+    vk::DescriptorBufferBindingInfoEXT binding() const;
+    vk::DeviceSize used() const;
+};
+
+} // namespace groot
@@ -6,9 +6,13 @@
 #include "src/include/structs.hpp"
 
 #include <string>
+#include <tuple>
 #include <unordered_map>
 #include <functional>
+#include <future>
+#include <mutex>
 #include <set>
+#include <span>
 #include <vector>
 
 class GLFWwindow;
@@ -16,10 +20,16 @@ class GLFWwindow;
 namespace groot {
 
 class Allocator;
+class BindlessHeap;
+class DescriptorAllocator;
+class DescriptorBuffer;
 class InputManager;
 class Object;
+class ReadbackRing;
 class Renderer;
 class ShaderCompiler;
+class ShaderWatcher;
+class ThreadPool;
 class VulkanContext;
 
 class alignas(64) Engine {
@@ -30,13 +40,33 @@ class alignas(64) Engine {
   ShaderCompiler * m_compiler = nullptr;
   Renderer * m_renderer = nullptr;
   InputManager * m_inputManager = nullptr;
+  ThreadPool * m_workers = nullptr;
+  ShaderWatcher * m_shaderWatcher = nullptr;
+  ReadbackRing * m_readbacks = nullptr;
+  DescriptorAllocator * m_descriptors = nullptr;
+  DescriptorBuffer * m_descriptorBuffer = nullptr;
+  BindlessHeap * m_bindless = nullptr;
 
   unsigned long m_nextRID = 1;
   std::unordered_map<RID, unsigned long, RID::Hash> m_resources;
-  std::set<RID> m_busySamplers;
+  std::unordered_map<RID, unsigned int, RID::Hash> m_refCounts;
+  std::unordered_map<SamplerSettings, RID, SamplerSettings::Hash> m_samplerCache;
+  std::multiset<RID> m_busySamplers;
+  std::unordered_map<unsigned long, RID> m_shaderCache;
+  std::unordered_map<unsigned long, RID> m_pipelineStates;
+  std::vector<RID> m_pendingPipelines;
+  std::vector<RID> m_optimizingPipelines;
+  std::unordered_map<unsigned long, std::pair<unsigned long, unsigned int>> m_pipelineLibraries;
+  std::mutex m_libraryMutex;
+  std::unordered_map<unsigned long, std::pair<unsigned long, unsigned int>> m_setLayouts;
+  std::unordered_map<unsigned long, std::pair<unsigned long, unsigned int>> m_pipelineLayouts;
+  std::vector<std::pair<RID, std::future<std::tuple<unsigned long, std::vector<unsigned int>, std::vector<std::string>>>>> m_shaderReloads;
+  std::vector<std::pair<unsigned long, std::function<void()>>> m_deletionQueue;
   std::set<unsigned long> m_storageTextures;
+  std::unordered_map<RID, unsigned int, RID::Hash> m_bindlessIndices;
+  RID m_bindlessSet;
+  std::set<RID> m_staleSets;
 
-  ImageHandle * m_drawOutput = nullptr;
   ImageHandle * m_renderTarget = nullptr;
 
   std::set<Object> m_scene;
@@ -47,6 +77,7 @@ class alignas(64) Engine {
 
   double m_frameTime = 0.0;
   double m_time = 0.0;
+  unsigned long m_frameCount = 0;
 
   public:
     explicit Engine(const Settings& settings = Settings{});
@@ -74,11 +105,17 @@ class alignas(64) Engine {
     void release_cursor() const;
     unsigned int flight_frames() const;
     unsigned int frame_index() const;
+    bool dynamic_pipeline_state() const;
+    bool descriptor_buffers() const;
 
     RID render_target();
     void translate_camera(const vec3&);
     void rotate_camera(float, float);
-    void run(std::function<void(double)> pre_draw = [](double){}, std::function<void(double)> post_draw = [](double){});
+    void run(
+      std::function<void(double)> pre_draw = [](double){},
+      std::function<void(double)> post_draw = [](double){},
+      const CaptureSettings& capture = {}
+    );
 
     RID create_uniform_buffer(unsigned int);
     RID create_storage_buffer(unsigned int);
@@ -120,23 +157,54 @@ class alignas(64) Engine {
     void destroy_sampler(RID&);
 
     RID create_storage_image(unsigned int, unsigned int, ImageType type = ImageType::two_dim, Format format = Format::rgba16_unorm);
+    RID create_storage_image(unsigned int, unsigned int, unsigned int, ImageType type = ImageType::three_dim, Format format = Format::rgba16_unorm);
     RID create_texture(const std::string&, const RID&);
     RID create_storage_texture(unsigned int, unsigned int, const RID&, ImageType type = ImageType::two_dim, Format format = Format::rgba16_unorm);
+    RID create_storage_texture(unsigned int, unsigned int, unsigned int, const RID&, ImageType type = ImageType::three_dim, Format format = Format::rgba16_unorm);
+    RID create_texture_array(const std::vector<std::string>&, const RID&);
+    RID create_texture_atlas(const std::vector<std::string>&, const RID&);
+    std::vector<vec4> atlas_regions(const RID&) const;
     void destroy_image(RID&);
 
-    RID compile_shader(ShaderType type, const std::string&);
+    template <typename T>
+    inline void write_image(const RID& rid, const std::vector<T>& data, unsigned int layer = 0) const {
+      writeImageRaw(rid, sizeof(T) * data.size(), data.data(), layer);
+    }
+
+    std::future<std::vector<unsigned char>> read_image_async(const RID&, const ImageRegion& region = {});
+
+    RID compile_shader(ShaderType type, const std::string&, const std::vector<ShaderDefine>& defines = {});
+    std::vector<RID> compile_shaders(std::span<const ShaderDesc>);
+    RID load_shader_spirv(ShaderType, const std::string&);
+    RID load_shader_spirv(ShaderType, std::span<const unsigned int>);
     void destroy_shader(RID&);
 
     RID create_descriptor_set(const std::vector<RID>&);
     void destroy_descriptor_set(RID&);
+    void update_descriptor_set(const RID&, unsigned int, const RID&);
+    unsigned int descriptor_pools() const;
+    RID bindless_set() const;
+    unsigned int bindless_index(const RID&) const;
 
-    RID create_compute_pipeline(const RID&, const RID&);
+    RID create_compute_pipeline(const RID&, const RID&, const SpecializationConstants& constants = {});
+    RID create_push_compute_pipeline(const RID&, const SpecializationConstants& constants = {});
     RID create_graphics_pipeline(const GraphicsPipelineShaders&, const RID&, const GraphicsPipelineSettings&);
+    RID create_graphics_pipeline(const GraphicsPipelineShaders&, const std::vector<RID>&, const GraphicsPipelineSettings&);
+    RID create_compute_pipeline_async(const RID&, const RID&, const SpecializationConstants& constants = {}, const RID& fallback = RID());
+    RID create_graphics_pipeline_async(const GraphicsPipelineShaders&, const RID&, const GraphicsPipelineSettings&, const RID& fallback = RID());
+    RID create_graphics_pipeline_async(const GraphicsPipelineShaders&, const std::vector<RID>&, const GraphicsPipelineSettings&, const RID& fallback = RID());
+    unsigned int pipelines_pending() const;
     void destroy_pipeline(RID&);
 
-    RID load_mesh(const std::string&);
+    RID load_mesh(const std::string&, const VertexFormat& format = StandardVertex::format());
+    mat4 mesh_dequantization(const RID&) const;
     void destroy_mesh(RID&);
 
+    template <typename Layout>
+    inline RID load_mesh(const std::string& path) {
+      return load_mesh(path, Layout::format());
+    }
+
     void dispatch(const ComputeCommand&);
 
     void add_to_scene(Object&);
@@ -152,8 +220,57 @@ class alignas(64) Engine {
 
   private:
     void updateTimes();
+    RID createTexture(unsigned int, unsigned int, unsigned int, const unsigned char *, const RID&);
+    PipelineHandle * prepareComputePipeline(const RID&, const RID&, const SpecializationConstants&);
+    PipelineHandle * prepareGraphicsPipeline(const GraphicsPipelineShaders&, const std::vector<RID>&, const GraphicsPipelineSettings&);
+    bool validateFallback(const RID&, const PipelineHandle *) const;
+    RID registerPipeline(PipelineHandle *, bool);
+    void finishPipeline(const RID&);
+    void resolvePipelines();
+    unsigned long pipelineKey(const PipelineHandle *) const;
+    vk::Pipeline buildPipeline(PipelineHandle *);
+    vk::Pipeline linkPipeline(const PipelineHandle *, bool) const;
+    vk::Pipeline acquirePipelineLibrary(unsigned long, const vk::GraphicsPipelineCreateInfo&);
+    void releasePipelineLibraries(PipelineHandle *);
+    void optimizePipeline(const RID&);
+    vk::ShaderModule shaderModule(const RID&) const;
+    void resolveModules(PipelineHandle *) const;
+    bool reflectPipeline(const PipelineHandle *, ShaderReflection&) const;
+    bool validateSpecialization(const SpecializationConstants&, const ShaderReflection&) const;
+    bool validateBindings(const std::vector<std::vector<vk::DescriptorSetLayoutBinding>>&, const ShaderReflection&) const;
+    bool describeDescriptors(const std::vector<RID>&, DescriptorWrites&) const;
+    DescriptorAllocation allocateDescriptors(const DescriptorSetHandle *);
+    void writeDescriptors(const DescriptorAllocation&, const DescriptorSetHandle *, std::vector<vk::WriteDescriptorSet>&);
+    void rewriteDescriptors(const DescriptorAllocation&, const DescriptorSetHandle *);
+    void freeDescriptors(const DescriptorAllocation&);
+    vk::DescriptorSetLayout acquireSetLayout(const std::vector<vk::DescriptorSetLayoutBinding>&, unsigned long&, bool push = false);
+    void retainSetLayout(unsigned long);
+    void releaseSetLayout(unsigned long);
+    void registerBindless(const RID&);
+    void releaseBindless(const RID&);
+    vk::PipelineLayout acquirePipelineLayout(const std::vector<vk::DescriptorSetLayout>&, const std::vector<unsigned long>&, const ShaderReflection&, vk::PushConstantRange&, unsigned long&);
+    void releasePipelineLayout(unsigned long);
+    void reloadShaders();
+    void refreshDescriptorSets();
+    void deferDeletion(std::function<void()>&&);
+    void flushDeletions(bool);
+    std::vector<unsigned int> readSpirv(const std::string&) const;
+    unsigned long spirvKey(ShaderType, const std::vector<unsigned int>&) const;
+    RID createShader(
+      ShaderType,
+      const std::string&,
+      const std::vector<ShaderDefine>&,
+      const std::vector<std::string>&,
+      unsigned long,
+      const std::vector<unsigned int>&,
+      bool
+    );
+    RID createStorageImage(unsigned int, unsigned int, unsigned int, ImageType, Format, const RID&);
+    unsigned int defaultLayers(ImageType) const;
+    bool validImageDimensions(unsigned int, unsigned int, unsigned int, ImageType) const;
     std::pair<unsigned int, void *> readBufferRaw(const RID&) const;
     void writeBufferRaw(const RID&, std::size_t, const void *) const;
+    void writeImageRaw(const RID&, std::size_t, const void *, unsigned int) const;
 };
 
 } // namespace groot
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "src/include/structs.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace groot {
+
+class FrameCapture {
+  struct Frame {
+    unsigned long index = 0;
+    std::vector<unsigned char> pixels;
+  };
+
+  CaptureSettings m_settings;
+  unsigned int m_width = 0;
+  unsigned int m_height = 0;
+  bool m_bgra = false;
+
+  unsigned long m_nextFrame = 0;
+  std::deque<std::future<std::vector<unsigned char>>> m_readbacks;
+
+  std::deque<Frame> m_queue;
+  std::mutex m_mutex;
+  std::condition_variable m_queueReady;
+  std::condition_variable m_queueSpace;
+  bool m_stop = false;
+  std::thread m_worker;
+
+  public:
+    FrameCapture(const CaptureSettings&, unsigned int, unsigned int, bool);
+    FrameCapture(const FrameCapture&) = delete;
+    FrameCapture(FrameCapture&&) = delete;
+
+    ~FrameCapture();
+
+    FrameCapture& operator=(const FrameCapture&) = delete;
+    FrameCapture& operator=(FrameCapture&&) = delete;
+
+    void track(std::future<std::vector<unsigned char>>&&);
+    void collect();
+
+  private:
+    void push(Frame&&);
+    void work();
+    void write(const Frame&) const;
+};
+
+std::vector<unsigned char> encodePNG(unsigned int, unsigned int, const std::vector<unsigned char>&);
+std::vector<unsigned char> encodeQOI(unsigned int, unsigned int, const std::vector<unsigned char>&);
+
+} // namespace groot
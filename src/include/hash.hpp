@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+namespace groot {
+
+constexpr unsigned long fnv1aOffset = 14695981039346656037ul;
+
+inline unsigned long fnv1a(const void * data, std::size_t size, unsigned long hash = fnv1aOffset) {
+  const unsigned char * bytes = static_cast<const unsigned char *>(data);
+  for (std::size_t i = 0; i < size; ++i) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ul;
+  }
+  return hash;
+}
+
+inline unsigned long fnv1a(std::string_view data, unsigned long hash = fnv1aOffset) {
+  return fnv1a(data.data(), data.size(), hash);
+}
+
+template <typename T>
+inline unsigned long fnv1aValue(const T& value, unsigned long hash = fnv1aOffset) {
+  return fnv1a(&value, sizeof(T), hash);
+}
+
+} // namespace groot
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+
+#include <future>
+#include <vector>
+
+namespace groot {
+
+class Allocator;
+
+class ReadbackRing {
+  struct Readback {
+    vk::Buffer buffer = nullptr;
+    std::size_t size = 0;
+    std::promise<std::vector<unsigned char>> promise;
+  };
+
+  std::vector<std::vector<Readback>> m_pending;
+  std::vector<vk::Buffer> m_free;
+
+  public:
+    explicit ReadbackRing(unsigned int);
+    ReadbackRing(const ReadbackRing&) = delete;
+    ReadbackRing(ReadbackRing&&) = delete;
+
+    ~ReadbackRing() = default;
+
+    ReadbackRing& operator=(const ReadbackRing&) = delete;
+    ReadbackRing& operator=(ReadbackRing&&) = delete;
+
+    unsigned int immediateSlot() const;
+
+    std::future<std::vector<unsigned char>> record(
+      Allocator *,
+      const vk::CommandBuffer&,
+      unsigned int,
+      const vk::Image&,
+      vk::ImageLayout,
+      const vk::BufferImageCopy&,
+      std::size_t
+    );
+    void resolve(Allocator *, unsigned int);
+    void resolveAll(Allocator *);
+    void destroy(Allocator *);
+
+  private:
+    vk::Buffer acquire(Allocator *, std::size_t);
+};
+
+} // namespace groot
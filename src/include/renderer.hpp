@@ -46,9 +46,13 @@ class Renderer {
   std::vector<vk::Semaphore> m_postProcessSemaphores;
   std::vector<vk::Semaphore> m_uiSemaphores;
 
+  vk::DescriptorBufferBindingInfoEXT m_descriptorBuffer{};
+
   unsigned int m_flightFrames = 0;
   unsigned int m_frameIndex = 0;
+  unsigned int m_imageIndex = 0;
   bool m_preDraw = false;
+  bool m_recording = false;
 
   public:
     Renderer(GLFWwindow *, const VulkanContext *, Allocator *, Settings&);
@@ -60,16 +64,26 @@ class Renderer {
     Renderer& operator=(const Renderer&) = delete;
     Renderer& operator=(Renderer&&) = delete;
 
+    vk::Format colorFormat() const;
     vk::Format depthFormat() const;
     std::pair<unsigned int, unsigned int> extent() const;
     std::pair<const vk::Image&, const vk::ImageView&> renderTarget(unsigned int) const;
     std::pair<const vk::Image&, const vk::ImageView&> drawTarget(unsigned int) const;
     unsigned int frameIndex() const;
+    unsigned int imageCount() const;
+    void setDescriptorBuffer(const vk::DescriptorBufferBindingInfoEXT&);
+    bool preDraw() const;
+    const vk::CommandBuffer * recordingCmd() const;
 
     void destroy(const VulkanContext *, Allocator *);
 
     void prepFrame(const VulkanContext *, std::unordered_map<RID, unsigned long, RID::Hash>&);
-    void dispatch(const VulkanContext *, const ComputeCommand&, const std::unordered_map<RID, unsigned long, RID::Hash>&);
+    void dispatch(
+      const VulkanContext *,
+      const ComputeCommand&,
+      const std::unordered_map<RID, unsigned long, RID::Hash>&,
+      const std::vector<vk::WriteDescriptorSet>& pushWrites = {}
+    );
     void beginDispatch(const VulkanContext *, const std::set<unsigned long>&);
     void endDispatch(const VulkanContext *, const std::set<unsigned long>&);
     unsigned int draw(const VulkanContext *, const std::set<unsigned long>&, const std::unordered_map<RID, unsigned long, RID::Hash>&, const std::set<Object>&);
@@ -79,6 +93,14 @@ class Renderer {
     void submit(const VulkanContext *, unsigned int);
 
   private:
+    void bindDescriptors(
+      const VulkanContext *,
+      const vk::CommandBuffer&,
+      vk::PipelineBindPoint,
+      const vk::PipelineLayout&,
+      unsigned int,
+      const DescriptorSetHandle *
+    ) const;
     vk::SurfaceFormatKHR checkFormat(const VulkanContext *, Settings&) const;
     vk::Format getDepthFormat(const VulkanContext *) const;
     vk::PresentModeKHR checkPresentMode(const VulkanContext *, Settings&) const;
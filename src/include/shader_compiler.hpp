@@ -1,17 +1,24 @@
 #pragma once
 
 #include "src/include/enums.hpp"
+#include "src/include/structs.hpp"
 
 #include <shaderc/shaderc.hpp>
 
 namespace groot {
 
+struct PreprocessedShader {
+  std::string source;
+  std::vector<std::string> includes;
+};
+
 class ShaderCompiler {
-  shaderc::Compiler m_compiler;
   shaderc::CompileOptions m_opts;
+  std::string m_cacheDirectory;
+  std::vector<std::string> m_includeDirectories;
 
   public:
-    ShaderCompiler();
+    explicit ShaderCompiler(const std::string& cacheDirectory = "", const std::vector<std::string>& includeDirectories = {});
     ShaderCompiler(const ShaderCompiler&) = delete;
     ShaderCompiler(ShaderCompiler&&) = delete;
 
@@ -20,10 +27,14 @@ class ShaderCompiler {
     ShaderCompiler& operator=(const ShaderCompiler&) = delete;
     ShaderCompiler& operator=(ShaderCompiler&&) = delete;
 
-    std::vector<unsigned int> compileShader(ShaderType, const std::string&) const;
+    std::string readSource(const std::string&) const;
+    PreprocessedShader preprocess(ShaderType, const std::string&, const std::string&, const std::vector<ShaderDefine>&) const;
+    unsigned long cacheKey(ShaderType, const std::string&) const;
+    std::vector<unsigned int> compileShader(ShaderType, const std::string&, const std::string&, unsigned long) const;
 
   private:
-    std::string stringify(const std::string& path) const;
+    std::vector<unsigned int> loadCached(unsigned long) const;
+    void storeCached(unsigned long, const std::vector<unsigned int>&) const;
 };
 
-} // namespace groot
\ No newline at end of file
+} // namespace groot
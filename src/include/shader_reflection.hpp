@@ -0,0 +1,29 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+
+#include <map>
+#include <vector>
+
+namespace groot {
+
+struct ReflectedBinding {
+  unsigned int set = 0;
+  unsigned int binding = 0;
+  vk::DescriptorType type = vk::DescriptorType::eUniformBuffer;
+  unsigned int count = 1;
+  vk::ShaderStageFlags stages = {};
+};
+
+struct ShaderReflection {
+  vk::ShaderStageFlags stage = {};
+  std::vector<ReflectedBinding> bindings;
+  unsigned int pushConstantSize = 0;
+  vk::ShaderStageFlags pushConstantStages = {};
+  std::map<unsigned int, unsigned int> specializationConstants;
+};
+
+ShaderReflection reflectShader(const std::vector<unsigned int>&);
+bool mergeReflection(ShaderReflection&, const ShaderReflection&);
+
+} // namespace groot
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <atomic>
+#include <filesystem>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace groot {
+
+class ShaderWatcher {
+  std::mutex m_mutex;
+  std::unordered_map<std::string, std::filesystem::file_time_type> m_files;
+  std::unordered_map<int, std::string> m_directories;
+  std::set<std::string> m_changed;
+
+  int m_fd = -1;
+  std::atomic<bool> m_stop = false;
+  std::thread m_thread;
+
+  public:
+    ShaderWatcher();
+    ShaderWatcher(const ShaderWatcher&) = delete;
+    ShaderWatcher(ShaderWatcher&&) = delete;
+
+    ~ShaderWatcher();
+
+    ShaderWatcher& operator=(const ShaderWatcher&) = delete;
+    ShaderWatcher& operator=(ShaderWatcher&&) = delete;
+
+    void watch(const std::string&);
+    std::vector<std::string> changed();
+
+  private:
+    void work();
+    void poll();
+};
+
+} // namespace groot
@@ -1,11 +1,19 @@
 #pragma once
 
+#include "src/include/descriptor_allocator.hpp"
 #include "src/include/enums.hpp"
 #include "src/include/linalg.hpp"
 #include "src/include/rid.hpp"
+#include "src/include/shader_reflection.hpp"
+#include "src/include/vertex_layout.hpp"
 
 #include <vulkan/vulkan.hpp>
 
+#include <algorithm>
+#include <future>
+#include <map>
+#include <type_traits>
+
 namespace groot {
 
 struct VkBufferHash {
@@ -28,6 +36,27 @@ struct Settings {
   float fov = 70.0f;
   unsigned int flight_frames = 3;
   vec4 background_color = vec4(0.0f, 0.0f, 0.0f, 1.0f);
+  std::string cache_directory = "";
+  std::string pipeline_cache_path = "";
+  unsigned int worker_threads = 0;
+  bool hot_reload_shaders = false;
+  bool dynamic_pipeline_state = false;
+  bool graphics_pipeline_libraries = true;
+  bool optimize_pipeline_libraries = true;
+  bool bindless_descriptors = false;
+  bool descriptor_buffers = false;
+  std::vector<std::string> shader_include_directories = {};
+};
+
+struct ShaderDefine {
+  std::string name;
+  std::string value = "";
+};
+
+struct ShaderDesc {
+  ShaderType type = ShaderType::Vertex;
+  std::string path;
+  std::vector<ShaderDefine> defines = {};
 };
 
 struct GraphicsPipelineShaders {
@@ -37,30 +66,97 @@ struct GraphicsPipelineShaders {
   RID tesselation_evaluation = RID();
 };
 
+struct SpecializationConstants {
+  std::map<unsigned int, std::vector<unsigned char>> values;
+
+  template <typename T>
+  SpecializationConstants& set(unsigned int id, const T& value) {
+    if constexpr (std::is_same_v<T, bool>)
+      return set(id, static_cast<unsigned int>(value));
+
+    const unsigned char * bytes = reinterpret_cast<const unsigned char *>(&value);
+    values[id] = std::vector<unsigned char>(bytes, bytes + sizeof(T));
+    return *this;
+  }
+};
+
 struct GraphicsPipelineSettings {
   MeshType mesh_type = MeshType::Solid;
   CullMode cull_mode = CullMode::Back;
   DrawDirection draw_direction = DrawDirection::CounterClockwise;
   bool enable_depth_test = true;
   bool enable_depth_write = true;
+  CompareOp depth_compare = CompareOp::Less;
   bool enable_blend = true;
+  VertexFormat vertex_format = StandardVertex::format();
+  SpecializationConstants specialization = {};
 };
 
 struct DescriptorSetHandle {
+  static constexpr std::size_t stride = std::max(sizeof(vk::DescriptorImageInfo), sizeof(vk::DescriptorBufferInfo));
+
   vk::DescriptorSetLayout layout = nullptr;
-  vk::DescriptorPool pool = nullptr;
   vk::DescriptorSet set = nullptr;
+  DescriptorAllocation allocation;
+  std::vector<DescriptorAllocation> copies;
+  std::vector<DescriptorAllocation> targets;
+  std::vector<vk::DescriptorSetLayoutBinding> bindings;
+  std::vector<unsigned char> data;
+  vk::DescriptorUpdateTemplate updateTemplate = nullptr;
+  unsigned int stale = 0;
+  unsigned long layoutKey = 0;
+};
+
+struct DescriptorWrites {
+  std::vector<vk::DescriptorSetLayoutBinding> bindings;
+  std::vector<vk::DescriptorBufferInfo> bufferInfos;
+  std::vector<vk::DescriptorImageInfo> imageInfos;
+  std::vector<vk::WriteDescriptorSet> writes;
+  std::vector<std::pair<std::size_t, bool>> targets;
+};
+
+struct ShaderHandle {
+  vk::ShaderModule module = nullptr;
+  ShaderType type = ShaderType::Vertex;
+  std::string path;
+  std::vector<ShaderDefine> defines;
+  std::vector<std::string> includes;
+  unsigned long key = 0;
+  ShaderReflection reflection;
+  bool precompiled = false;
 };
 
 struct PipelineHandle {
   vk::PipelineLayout layout = nullptr;
   vk::Pipeline pipeline = nullptr;
+  vk::PipelineBindPoint bindPoint = vk::PipelineBindPoint::eGraphics;
+  RID compute = RID();
+  GraphicsPipelineShaders shaders;
+  GraphicsPipelineSettings settings;
+  SpecializationConstants specialization;
+  std::vector<std::vector<vk::DescriptorSetLayoutBinding>> bindings;
+  ShaderReflection reflection;
+  vk::PushConstantRange pushConstants = {};
+  unsigned long layoutKey = 0;
+  std::vector<unsigned long> setLayoutKeys;
+  bool pushDescriptors = false;
+  unsigned long key = 0;
+  std::vector<std::pair<vk::ShaderStageFlagBits, vk::ShaderModule>> modules;
+  std::vector<unsigned long> moduleKeys;
+  std::vector<std::pair<unsigned long, vk::Pipeline>> libraries;
+  std::future<vk::Pipeline> pending;
+  std::future<vk::Pipeline> optimized;
+  RID fallback = RID();
 };
 
 struct ImageHandle {
   vk::Image image = nullptr;
   vk::ImageView view = nullptr;
   RID sampler = RID();
+  vk::Format format = vk::Format::eUndefined;
+  vk::Extent3D extent = { 0, 0, 0 };
+  unsigned int layers = 1;
+  std::vector<vec4> regions;
 };
 
 struct SamplerSettings {
@@ -70,11 +166,39 @@ struct SamplerSettings {
   SampleMode mode_v = SampleMode::Repeat;
   SampleMode mode_w = SampleMode::Repeat;
   bool anisotropic_filtering = true;
+  float mip_lod_bias = 0.0f;
+  bool enable_compare = false;
+  CompareOp compare_op = CompareOp::LessOrEqual;
+  BorderColor border_color = BorderColor::FloatTransparentBlack;
+
+  struct Hash {
+    std::size_t operator()(const SamplerSettings&) const;
+  };
+
+  bool operator==(const SamplerSettings&) const = default;
+};
+
+struct ImageRegion {
+  unsigned int x = 0;
+  unsigned int y = 0;
+  unsigned int z = 0;
+  unsigned int width = 0;
+  unsigned int height = 0;
+  unsigned int depth = 0;
+  unsigned int layer = 0;
+};
+
+struct CaptureSettings {
+  CaptureFormat format = CaptureFormat::None;
+  std::string directory = "capture";
+  std::string prefix = "frame";
+  unsigned int max_queued_frames = 4;
 };
 
 struct ComputeCommand {
   RID pipeline = RID();
   RID descriptor_set = RID();
+  std::vector<RID> push_descriptors = {};
   std::vector<unsigned char> push_constants;
   std::tuple<unsigned int, unsigned int, unsigned int> work_groups = { 1, 1, 1 };
   bool barrier = false;
@@ -90,15 +214,15 @@ struct Vertex {
   };
 
   bool operator==(const Vertex&) const;
-
-  static vk::VertexInputBindingDescription binding();
-  static std::array<vk::VertexInputAttributeDescription, 3> attributes();
 };
 
 struct MeshHandle {
   vk::Buffer vertexBuffer = nullptr;
   vk::Buffer indexBuffer  = nullptr;
   unsigned int indexCount = 0;
+  unsigned long formatKey = 0;
+  vec3 offset = vec3(0.0f);
+  vec3 scale = vec3(1.0f);
 };
 
 struct Transform {
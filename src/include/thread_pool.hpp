@@ -0,0 +1,52 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace groot {
+
+class ThreadPool {
+  std::vector<std::thread> m_threads;
+  std::deque<std::function<void()>> m_tasks;
+  std::mutex m_mutex;
+  std::condition_variable m_taskReady;
+  bool m_stop = false;
+
+  public:
+    explicit ThreadPool(unsigned int);
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool(ThreadPool&&) = delete;
+
+    ~ThreadPool();
+
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ThreadPool& operator=(ThreadPool&&) = delete;
+
+    unsigned int size() const;
+
+    template <typename F>
+    inline std::future<std::invoke_result_t<F>> submit(F&& function) {
+      auto task = std::make_shared<std::packaged_task<std::invoke_result_t<F>()>>(std::forward<F>(function));
+      std::future<std::invoke_result_t<F>> future = task->get_future();
+
+      {
+        std::lock_guard lock(m_mutex);
+        m_tasks.emplace_back([task] { (*task)(); });
+      }
+      m_taskReady.notify_one();
+
+      return future;
+    }
+
+  private:
+    void work();
+};
+
+} // namespace groot
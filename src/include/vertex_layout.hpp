@@ -0,0 +1,102 @@
+#pragma once
+
+#include "src/include/enums.hpp"
+#include "src/include/linalg.hpp"
+
+#include <array>
+#include <utility>
+#include <vector>
+
+namespace groot {
+
+struct VertexElement {
+  VertexAttribute attribute = VertexAttribute::Position;
+  VertexEncoding encoding = VertexEncoding::Float32;
+  Format format = Format::undefined;
+  unsigned int offset = 0;
+};
+
+struct VertexFormat {
+  std::vector<VertexElement> elements;
+  unsigned int stride = 0;
+};
+
+template <VertexAttribute A, VertexEncoding E = VertexEncoding::Float32>
+struct VertexInput {
+  static_assert(E != VertexEncoding::Unorm16 || A == VertexAttribute::UV, "unorm16 is only supported for UVs");
+  static_assert(E != VertexEncoding::Octahedral16 || A == VertexAttribute::Normal, "octahedral encoding is only supported for normals");
+  static_assert(E != VertexEncoding::Snorm8 || A == VertexAttribute::Normal, "snorm8 is only supported for normals");
+
+  static constexpr VertexAttribute attribute = A;
+  static constexpr VertexEncoding encoding = E;
+  static constexpr unsigned int components = A == VertexAttribute::UV || E == VertexEncoding::Octahedral16 ? 2 : 3;
+
+  static constexpr Format format = [] {
+    switch (E) {
+      case VertexEncoding::Float32:       return components == 2 ? Format::rg32_sfloat : Format::rgb32_sfloat;
+      case VertexEncoding::Float16:       return components == 2 ? Format::rg16_sfloat : Format::rgba16_sfloat;
+      case VertexEncoding::Snorm16:       return components == 2 ? Format::rg16_snorm : Format::rgba16_snorm;
+      case VertexEncoding::Unorm16:       return Format::rg16_unorm;
+      case VertexEncoding::Snorm8:        return Format::rgba8_snorm;
+      case VertexEncoding::Octahedral16:  return Format::rg16_snorm;
+    }
+    return Format::undefined;
+  }();
+
+  static constexpr unsigned int size = [] {
+    switch (E) {
+      case VertexEncoding::Float32:       return components * 4;
+      case VertexEncoding::Snorm8:        return 4u;
+      case VertexEncoding::Octahedral16:  return 4u;
+      default:                            return components == 2 ? 4u : 8u;
+    }
+  }();
+};
+
+template <typename... Inputs>
+struct VertexLayout {
+  static_assert(sizeof...(Inputs) > 0, "a vertex layout needs at least one input");
+
+  static constexpr unsigned int stride = (Inputs::size + ...);
+
+  static constexpr std::array<VertexElement, sizeof...(Inputs)> elements = [] {
+    std::array<VertexElement, sizeof...(Inputs)> elements{
+      VertexElement{ Inputs::attribute, Inputs::encoding, Inputs::format, 0 }...
+    };
+
+    unsigned int offset = 0, index = 0;
+    ((elements[index++].offset = std::exchange(offset, offset + Inputs::size)), ...);
+
+    return elements;
+  }();
+
+  static_assert([] {
+    for (unsigned int i = 0; i < elements.size(); ++i)
+      for (unsigned int j = i + 1; j < elements.size(); ++j)
+        if (elements[i].attribute == elements[j].attribute) return false;
+    return true;
+  }(), "a vertex layout can only contain each attribute once");
+
+  static VertexFormat format() {
+    return VertexFormat{ std::vector<VertexElement>(elements.begin(), elements.end()), stride };
+  }
+};
+
+using StandardVertex = VertexLayout<
+  VertexInput<VertexAttribute::Position>,
+  VertexInput<VertexAttribute::UV>,
+  VertexInput<VertexAttribute::Normal>
+>;
+
+using CompactVertex = VertexLayout<
+  VertexInput<VertexAttribute::Position, VertexEncoding::Snorm16>,
+  VertexInput<VertexAttribute::UV, VertexEncoding::Float16>,
+  VertexInput<VertexAttribute::Normal, VertexEncoding::Octahedral16>
+>;
+
+struct Vertex;
+
+std::vector<unsigned char> encodeVertices(const VertexFormat&, const std::vector<Vertex>&, const vec3&, const vec3&);
+unsigned long vertexFormatKey(const VertexFormat&, unsigned long);
+
+} // namespace groot
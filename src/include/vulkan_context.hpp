@@ -6,6 +6,8 @@ class GLFWwindow;
 
 namespace groot {
 
+struct Settings;
+
 class VulkanContext {
   vk::Instance m_instance = nullptr;
   vk::SurfaceKHR m_surface = nullptr;
@@ -24,6 +26,24 @@ class VulkanContext {
 
   vk::DescriptorPool m_guiDescriptorPool = nullptr;
 
+  vk::PipelineCache m_pipelineCache = nullptr;
+  std::string m_pipelineCachePath;
+
+  bool m_dynamicState = false;
+  bool m_dynamicBlend = false;
+  bool m_pipelineLibraries = false;
+  bool m_bindless = false;
+  unsigned int m_maxPushDescriptors = 0;
+  bool m_descriptorBuffers = false;
+  vk::PhysicalDeviceDescriptorBufferPropertiesEXT m_descriptorBufferProperties{};
+  PFN_vkCmdSetColorBlendEnableEXT m_cmdSetColorBlendEnable = nullptr;
+  PFN_vkCmdPushDescriptorSetKHR m_cmdPushDescriptorSet = nullptr;
+  PFN_vkGetDescriptorSetLayoutSizeEXT m_getDescriptorSetLayoutSize = nullptr;
+  PFN_vkGetDescriptorSetLayoutBindingOffsetEXT m_getDescriptorSetLayoutBindingOffset = nullptr;
+  PFN_vkGetDescriptorEXT m_getDescriptor = nullptr;
+  PFN_vkCmdBindDescriptorBuffersEXT m_cmdBindDescriptorBuffers = nullptr;
+  PFN_vkCmdSetDescriptorBufferOffsetsEXT m_cmdSetDescriptorBufferOffsets = nullptr;
+
   public:
     VulkanContext(const std::string&, const unsigned int&);
     VulkanContext(const VulkanContext&) = delete;
@@ -52,15 +72,35 @@ class VulkanContext {
     bool supportsTesselation() const;
     bool supportsNonSolidMesh() const;
     bool supportsAnisotropy() const;
+    bool supportsDynamicState() const;
+    bool supportsDynamicBlend() const;
+    bool supportsPipelineLibraries() const;
+    bool supportsBindless() const;
+    bool supportsPushDescriptors() const;
+    unsigned int maxPushDescriptors() const;
+    bool supportsDescriptorBuffers() const;
+    const vk::PhysicalDeviceDescriptorBufferPropertiesEXT& descriptorBufferProperties() const;
+    vk::PipelineCreateFlags pipelineCreateFlags() const;
+    void setColorBlendEnable(const vk::CommandBuffer&, bool) const;
+    void pushDescriptorSet(const vk::CommandBuffer&, vk::PipelineBindPoint, const vk::PipelineLayout&, const std::vector<vk::WriteDescriptorSet>&) const;
+    vk::DeviceSize descriptorSetLayoutSize(const vk::DescriptorSetLayout&) const;
+    vk::DeviceSize descriptorBindingOffset(const vk::DescriptorSetLayout&, unsigned int) const;
+    void getDescriptor(const vk::DescriptorGetInfoEXT&, std::size_t, void *) const;
+    void bindDescriptorBuffer(const vk::CommandBuffer&, const vk::DescriptorBufferBindingInfoEXT&) const;
+    void setDescriptorBufferOffset(const vk::CommandBuffer&, vk::PipelineBindPoint, const vk::PipelineLayout&, unsigned int, vk::DeviceSize) const;
+    const vk::PipelineCache& pipelineCache() const;
+    void savePipelineCache() const;
 
     void createSurface(GLFWwindow *);
     void chooseGPU(const unsigned int&, const std::vector<const char *>&);
-    void createDevice(std::vector<const char *>&);
+    void createDevice(std::vector<const char *>&, const Settings&);
     void createCommandPools();
+    void createPipelineCache(const std::string&);
 
   private:
     unsigned int getQueueFamilyIndices() const;
     std::vector<vk::DeviceQueueCreateInfo> getQueueCreateInfos(const float&) const;
+    std::vector<unsigned char> loadPipelineCacheData() const;
 };
 
 } // namespace groot
\ No newline at end of file
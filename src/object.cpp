@@ -1,10 +1,14 @@
 #include "src/include/log.hpp"
 #include "src/include/object.hpp"
 
+#include <format>
+
 namespace groot {
 
 Object::Object(const Object& obj)
-: m_id(RID()), m_mesh(obj.m_mesh), m_pipeline(obj.m_pipeline), m_set(obj.m_set) {}
+: m_id(RID()), m_mesh(obj.m_mesh), m_pipeline(obj.m_pipeline), m_sets(obj.m_sets), m_pushConstants(obj.m_pushConstants),
+  m_cullMode(obj.m_cullMode), m_drawDirection(obj.m_drawDirection), m_depthCompare(obj.m_depthCompare),
+  m_depthTest(obj.m_depthTest), m_depthWrite(obj.m_depthWrite), m_blend(obj.m_blend) {}
 
 Object& Object::operator=(const Object& obj) {
   if (this == &obj) return *this;
@@ -12,7 +16,14 @@ Object& Object::operator=(const Object& obj) {
   m_id = RID();
   m_mesh = obj.m_mesh;
   m_pipeline = obj.m_pipeline;
-  m_set = obj.m_set;
+  m_sets = obj.m_sets;
+  m_pushConstants = obj.m_pushConstants;
+  m_cullMode = obj.m_cullMode;
+  m_drawDirection = obj.m_drawDirection;
+  m_depthCompare = obj.m_depthCompare;
+  m_depthTest = obj.m_depthTest;
+  m_depthWrite = obj.m_depthWrite;
+  m_blend = obj.m_blend;
 
   return *this;
 }
@@ -53,7 +64,7 @@ void Object::set_pipeline(const RID& rid) {
   m_pipeline = rid;
 }
 
-void Object::set_descriptor_set(const RID& rid) {
+void Object::set_descriptor_set(const RID& rid, unsigned int set) {
   if (!rid.is_valid()) {
     Log::warn("tried to set object descriptor set to invalid RID");
     return;
@@ -64,7 +75,40 @@ void Object::set_descriptor_set(const RID& rid) {
     return;
   }
 
-  m_set = rid;
+  if (set >= m_sets.size()) {
+    Log::warn(std::format("tried to set object descriptor set {} but objects hold at most {} sets", set, m_sets.size()));
+    return;
+  }
+
+  m_sets[set] = rid;
+}
+
+void Object::set_cull_mode(CullMode mode) {
+  m_cullMode = mode;
+}
+
+void Object::set_draw_direction(DrawDirection direction) {
+  m_drawDirection = direction;
+}
+
+void Object::set_depth_test(bool enable) {
+  m_depthTest = enable;
+}
+
+void Object::set_depth_write(bool enable) {
+  m_depthWrite = enable;
+}
+
+void Object::set_depth_compare(CompareOp op) {
+  m_depthCompare = op;
+}
+
+void Object::set_blend(bool enable) {
+  m_blend = enable;
+}
+
+void Object::set_push_constants(const std::vector<unsigned char>& data) {
+  m_pushConstants = data;
 }
 
 } // namespace groot
\ No newline at end of file
@@ -0,0 +1,123 @@
+#include "src/include/allocator.hpp"
+#include "src/include/readback_ring.hpp"
+
+#include <cstring>
+
+namespace groot {
+
+ReadbackRing::ReadbackRing(unsigned int frames) : m_pending(frames + 1) {}
+
+unsigned int ReadbackRing::immediateSlot() const {
+  return m_pending.size() - 1;
+}
+
+std::future<std::vector<unsigned char>> ReadbackRing::record(
+  Allocator * allocator,
+  const vk::CommandBuffer& cmd,
+  unsigned int slot,
+  const vk::Image& image,
+  vk::ImageLayout layout,
+  const vk::BufferImageCopy& region,
+  std::size_t size
+) {
+  Readback& readback = m_pending[slot].emplace_back();
+  readback.buffer = acquire(allocator, size);
+  readback.size = size;
+
+  vk::ImageLayout copyLayout = layout == vk::ImageLayout::eGeneral ? layout : vk::ImageLayout::eTransferSrcOptimal;
+  vk::ImageSubresourceRange range{
+    .aspectMask     = vk::ImageAspectFlagBits::eColor,
+    .levelCount     = 1,
+    .baseArrayLayer = region.imageSubresource.baseArrayLayer,
+    .layerCount     = region.imageSubresource.layerCount
+  };
+
+  cmd.pipelineBarrier(
+    vk::PipelineStageFlagBits::eAllCommands,
+    vk::PipelineStageFlagBits::eTransfer,
+    {},
+    nullptr,
+    nullptr,
+    vk::ImageMemoryBarrier{
+      .srcAccessMask    = vk::AccessFlagBits::eShaderWrite | vk::AccessFlagBits::eColorAttachmentWrite,
+      .dstAccessMask    = vk::AccessFlagBits::eTransferRead,
+      .oldLayout        = layout,
+      .newLayout        = copyLayout,
+      .image            = image,
+      .subresourceRange = range
+    }
+  );
+
+  cmd.copyImageToBuffer(image, copyLayout, readback.buffer, region);
+
+  cmd.pipelineBarrier(
+    vk::PipelineStageFlagBits::eTransfer,
+    vk::PipelineStageFlagBits::eAllCommands,
+    {},
+    vk::MemoryBarrier{
+      .srcAccessMask = vk::AccessFlagBits::eTransferWrite,
+      .dstAccessMask = vk::AccessFlagBits::eHostRead
+    },
+    nullptr,
+    vk::ImageMemoryBarrier{
+      .srcAccessMask    = vk::AccessFlagBits::eTransferRead,
+      .dstAccessMask    = vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite,
+      .oldLayout        = copyLayout,
+      .newLayout        = layout,
+      .image            = image,
+      .subresourceRange = range
+    }
+  );
+
+  return readback.promise.get_future();
+}
+
+void ReadbackRing::resolve(Allocator * allocator, unsigned int slot) {
+  for (auto& readback : m_pending[slot]) {
+    std::vector<unsigned char> data(readback.size);
+
+    allocator->invalidateBuffer(readback.buffer);
+    void * map = allocator->mapBuffer(readback.buffer);
+    std::memcpy(data.data(), map, readback.size);
+    allocator->unmapBuffer(readback.buffer);
+
+    readback.promise.set_value(std::move(data));
+    m_free.emplace_back(readback.buffer);
+  }
+  m_pending[slot].clear();
+}
+
+void ReadbackRing::resolveAll(Allocator * allocator) {
+  for (unsigned int i = 0; i < m_pending.size(); ++i)
+    resolve(allocator, i);
+}
+
+void ReadbackRing::destroy(Allocator * allocator) {
+  resolveAll(allocator);
+
+  for (const auto& buffer : m_free)
+    allocator->destroyBuffer(buffer);
+  m_free.clear();
+}
+
+vk::Buffer ReadbackRing::acquire(Allocator * allocator, std::size_t size) {
+  auto best = m_free.end();
+  for (auto it = m_free.begin(); it != m_free.end(); ++it) {
+    std::size_t capacity = allocator->bufferSize(*it);
+    if (capacity >= size && (best == m_free.end() || capacity < allocator->bufferSize(*best)))
+      best = it;
+  }
+
+  if (best != m_free.end()) {
+    vk::Buffer buffer = *best;
+    m_free.erase(best);
+    return buffer;
+  }
+
+  return allocator->allocateBuffer(vk::BufferCreateInfo{
+    .size   = size,
+    .usage  = vk::BufferUsageFlagBits::eTransferDst
+  }, VMA_MEMORY_USAGE_AUTO, VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT);
+}
+
+} // namespace groot
@@ -45,6 +45,7 @@ Renderer::Renderer(
     .imageArrayLayers = 1,
     .imageUsage       = vk::ImageUsageFlagBits::eColorAttachment  |
                         vk::ImageUsageFlagBits::eStorage          |
+                        vk::ImageUsageFlagBits::eTransferSrc      |
                         vk::ImageUsageFlagBits::eTransferDst,
     .presentMode      = m_presentMode
   };
@@ -271,6 +272,7 @@ Renderer::Renderer(
     .DescriptorPool       = m_guiDescriptorPool,
     .MinImageCount        = capabilities.minImageCount,
     .ImageCount           = imageCount,
+    .PipelineCache        = context->pipelineCache(),
     .PipelineInfoMain     = {
       .MSAASamples = VK_SAMPLE_COUNT_1_BIT,
       .PipelineRenderingCreateInfo = {
@@ -291,6 +293,10 @@ Renderer::Renderer(
   context->device().destroyFence(transferFence);
 }
 
+vk::Format Renderer::colorFormat() const {
+  return m_colorFormat.format;
+}
+
 vk::Format Renderer::depthFormat() const {
   return m_depthFormat;
 }
@@ -311,6 +317,23 @@ unsigned int Renderer::frameIndex() const {
   return m_frameIndex;
 }
 
+unsigned int Renderer::imageCount() const {
+  return m_images.size();
+}
+
+void Renderer::setDescriptorBuffer(const vk::DescriptorBufferBindingInfoEXT& binding) {
+  m_descriptorBuffer = binding;
+}
+
+bool Renderer::preDraw() const {
+  return m_preDraw;
+}
+
+const vk::CommandBuffer * Renderer::recordingCmd() const {
+  if (!m_recording) return nullptr;
+  return m_preDraw ? &m_dispatchCmds[m_frameIndex] : &m_postProcessCmds[m_frameIndex];
+}
+
 void Renderer::destroy(const VulkanContext * context, Allocator * allocator) {
   ImGui_ImplVulkan_Shutdown();
   ImGui_ImplGlfw_Shutdown();
@@ -357,26 +380,26 @@ void Renderer::prepFrame(const VulkanContext * context, std::unordered_map<RID,
 void Renderer::dispatch(
   const VulkanContext * context,
   const ComputeCommand& command,
-  const std::unordered_map<RID, unsigned long, RID::Hash>& resources
+  const std::unordered_map<RID, unsigned long, RID::Hash>& resources,
+  const std::vector<vk::WriteDescriptorSet>& pushWrites
 ) {
   vk::CommandBuffer& cmd = m_preDraw ? m_dispatchCmds[m_frameIndex] : m_postProcessCmds[m_frameIndex];
 
   PipelineHandle * pipeline = reinterpret_cast<PipelineHandle *>(resources.at(command.pipeline));
-  DescriptorSetHandle * set = reinterpret_cast<DescriptorSetHandle *>(resources.at(command.descriptor_set));
 
   cmd.bindPipeline(vk::PipelineBindPoint::eCompute, pipeline->pipeline);
-  cmd.bindDescriptorSets(
-    vk::PipelineBindPoint::eCompute,
-    pipeline->layout,
-    0,
-    set->set,
-    nullptr
-  );
+  if (pipeline->pushDescriptors) {
+    if (!pushWrites.empty())
+      context->pushDescriptorSet(cmd, vk::PipelineBindPoint::eCompute, pipeline->layout, pushWrites);
+  }
+  else {
+    bindDescriptors(context, cmd, vk::PipelineBindPoint::eCompute, pipeline->layout, 0, reinterpret_cast<DescriptorSetHandle *>(resources.at(command.descriptor_set)));
+  }
 
   if (!command.push_constants.empty()) {
     cmd.pushConstants<unsigned char>(
       pipeline->layout,
-      vk::ShaderStageFlagBits::eCompute,
+      pipeline->pushConstants.stageFlags,
       0,
       command.push_constants
     );
@@ -404,10 +427,12 @@ void Renderer::dispatch(
 
 void Renderer::beginDispatch(const VulkanContext * context, const std::set<unsigned long>& imageHandles) {
   m_preDraw = true;
+  m_recording = true;
 
   vk::CommandBuffer& cmd = m_dispatchCmds[m_frameIndex];
   cmd.reset();
   cmd.begin(vk::CommandBufferBeginInfo{});
+  if (m_descriptorBuffer.address) context->bindDescriptorBuffer(cmd, m_descriptorBuffer);
 
   std::vector<vk::ImageMemoryBarrier> barriers;
   for (const auto& handle : imageHandles) {
@@ -419,7 +444,7 @@ void Renderer::beginDispatch(const VulkanContext * context, const std::set<unsig
       .subresourceRange = {
         .aspectMask = vk::ImageAspectFlagBits::eColor,
         .levelCount = 1,
-        .layerCount = 1
+        .layerCount = vk::RemainingArrayLayers
       }
     });
   }
@@ -435,6 +460,8 @@ void Renderer::beginDispatch(const VulkanContext * context, const std::set<unsig
 }
 
 void Renderer::endDispatch(const VulkanContext * context, const std::set<unsigned long>& imageHandles) {
+  m_recording = false;
+
   vk::CommandBuffer& cmd = m_dispatchCmds[m_frameIndex];
 
   auto [graphicsIndex, graphicsQueue] = context->graphicsQueue();
@@ -453,7 +480,7 @@ void Renderer::endDispatch(const VulkanContext * context, const std::set<unsigne
       .subresourceRange = {
         .aspectMask = vk::ImageAspectFlagBits::eColor,
         .levelCount = 1,
-        .layerCount = 1
+        .layerCount = vk::RemainingArrayLayers
       }
     });
   }
@@ -479,6 +506,7 @@ unsigned int Renderer::draw(
   vk::CommandBuffer& cmd = m_drawCmds[m_frameIndex];
   cmd.reset();
   cmd.begin(vk::CommandBufferBeginInfo{});
+  if (m_descriptorBuffer.address) context->bindDescriptorBuffer(cmd, m_descriptorBuffer);
 
   auto [graphicsIndex, graphicsQueue] = context->graphicsQueue();
   auto [computeIndex, computeQueue] = context->computeQueue();
@@ -497,7 +525,7 @@ unsigned int Renderer::draw(
         .subresourceRange = {
           .aspectMask = vk::ImageAspectFlagBits::eColor,
           .levelCount = 1,
-          .layerCount = 1
+          .layerCount = vk::RemainingArrayLayers
         }
       });
     }
@@ -572,22 +600,98 @@ unsigned int Renderer::draw(
 
   cmd.setScissor(0, vk::Rect2D{ .extent = m_extent });
 
+  PipelineHandle * boundPipeline = nullptr;
+  vk::PipelineLayout boundLayout = nullptr;
+  std::array<DescriptorSetHandle *, 4> boundSets{};
+  MeshHandle * boundMesh = nullptr;
+  std::optional<CullMode> boundCullMode;
+  std::optional<DrawDirection> boundDrawDirection;
+  std::optional<bool> boundDepthTest;
+  std::optional<bool> boundDepthWrite;
+  std::optional<CompareOp> boundDepthCompare;
+  std::optional<bool> boundBlend;
+
   for (const auto& object : scene) {
     PipelineHandle * pipeline = reinterpret_cast<PipelineHandle *>(resources.at(object.m_pipeline));
-    DescriptorSetHandle * set = reinterpret_cast<DescriptorSetHandle *>(resources.at(object.m_set));
+    if (!pipeline->pipeline) {
+      if (!pipeline->fallback.is_valid() || !resources.contains(pipeline->fallback)) continue;
+
+      pipeline = reinterpret_cast<PipelineHandle *>(resources.at(pipeline->fallback));
+      if (!pipeline->pipeline) continue;
+    }
+
+    std::array<DescriptorSetHandle *, 4> sets{};
+    bool complete = true;
+    for (unsigned int i = 0; i < pipeline->bindings.size(); ++i) {
+      complete &= resources.contains(object.m_sets[i]);
+      if (complete) sets[i] = reinterpret_cast<DescriptorSetHandle *>(resources.at(object.m_sets[i]));
+    }
+    if (!complete) continue;
+
     MeshHandle * mesh = reinterpret_cast<MeshHandle *>(resources.at(object.m_mesh));
 
-    cmd.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline->pipeline);
-    cmd.bindDescriptorSets(
-      vk::PipelineBindPoint::eGraphics,
-      pipeline->layout,
-      0,
-      set->set,
-      nullptr
-    );
-    cmd.bindVertexBuffers(0, mesh->vertexBuffer, { 0 });
-    cmd.bindIndexBuffer(mesh->indexBuffer, 0, vk::IndexType::eUint32);
+    if (pipeline != boundPipeline)
+      cmd.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline->pipeline);
+
+    if (pipeline->layout != boundLayout) {
+      boundSets.fill(nullptr);
+      boundLayout = pipeline->layout;
+    }
+
+    for (unsigned int i = 0; i < pipeline->bindings.size(); ++i) {
+      if (sets[i] == boundSets[i]) continue;
+
+      bindDescriptors(context, cmd, vk::PipelineBindPoint::eGraphics, pipeline->layout, i, sets[i]);
+    }
+
+    if (!object.m_pushConstants.empty())
+      cmd.pushConstants<unsigned char>(pipeline->layout, pipeline->pushConstants.stageFlags, 0, object.m_pushConstants);
+
+    if (mesh != boundMesh) {
+      cmd.bindVertexBuffers(0, mesh->vertexBuffer, { 0 });
+      cmd.bindIndexBuffer(mesh->indexBuffer, 0, vk::IndexType::eUint32);
+    }
+
+    if (context->supportsDynamicState()) {
+      const GraphicsPipelineSettings& settings = pipeline->settings;
+
+      CullMode cullMode = object.m_cullMode.value_or(settings.cull_mode);
+      if (cullMode != boundCullMode)
+        cmd.setCullMode(static_cast<vk::CullModeFlagBits>(cullMode));
+
+      DrawDirection drawDirection = object.m_drawDirection.value_or(settings.draw_direction);
+      if (drawDirection != boundDrawDirection)
+        cmd.setFrontFace(static_cast<vk::FrontFace>(drawDirection));
+
+      bool depthTest = object.m_depthTest.value_or(settings.enable_depth_test);
+      if (depthTest != boundDepthTest)
+        cmd.setDepthTestEnable(depthTest);
+
+      bool depthWrite = object.m_depthWrite.value_or(settings.enable_depth_write);
+      if (depthWrite != boundDepthWrite)
+        cmd.setDepthWriteEnable(depthWrite);
+
+      CompareOp depthCompare = object.m_depthCompare.value_or(settings.depth_compare);
+      if (depthCompare != boundDepthCompare)
+        cmd.setDepthCompareOp(static_cast<vk::CompareOp>(depthCompare));
+
+      bool blend = object.m_blend.value_or(settings.enable_blend);
+      if (context->supportsDynamicBlend() && blend != boundBlend)
+        context->setColorBlendEnable(cmd, blend);
+
+      boundCullMode = cullMode;
+      boundDrawDirection = drawDirection;
+      boundDepthTest = depthTest;
+      boundDepthWrite = depthWrite;
+      boundDepthCompare = depthCompare;
+      boundBlend = blend;
+    }
+
     cmd.drawIndexed(mesh->indexCount, 1, 0, 0, 0);
+
+    boundPipeline = pipeline;
+    boundSets = sets;
+    boundMesh = mesh;
   }
 
   cmd.endRendering();
@@ -690,10 +794,13 @@ unsigned int Renderer::draw(
 
 void Renderer::beginPostProcess(const VulkanContext * context, unsigned int imgIndex) {
   m_preDraw = false;
+  m_recording = true;
+  m_imageIndex = imgIndex;
 
   vk::CommandBuffer& cmd = m_postProcessCmds[m_frameIndex];
   cmd.reset();
   cmd.begin(vk::CommandBufferBeginInfo{});
+  if (m_descriptorBuffer.address) context->bindDescriptorBuffer(cmd, m_descriptorBuffer);
 
   auto [drawImage, drawView] = drawTarget(imgIndex);
   auto [renderImage, renderView] = renderTarget(imgIndex);
@@ -743,6 +850,8 @@ void Renderer::beginPostProcess(const VulkanContext * context, unsigned int imgI
 }
 
 void Renderer::endPostProcess(const VulkanContext * context, unsigned int imgIndex) {
+  m_recording = false;
+
   vk::CommandBuffer& cmd = m_postProcessCmds[m_frameIndex];
 
   auto [graphicsIndex, graphicsQueue] = context->graphicsQueue();
@@ -942,6 +1051,23 @@ void Renderer::submit(const VulkanContext * context, unsigned int imgIndex) {
   m_frameIndex = (m_frameIndex + 1) % m_flightFrames;
 }
 
+void Renderer::bindDescriptors(
+  const VulkanContext * context,
+  const vk::CommandBuffer& cmd,
+  vk::PipelineBindPoint bindPoint,
+  const vk::PipelineLayout& layout,
+  unsigned int index,
+  const DescriptorSetHandle * set
+) const {
+  const DescriptorAllocation& allocation = !set->targets.empty() ? set->targets[m_imageIndex] :
+    set->copies.empty() ? set->allocation : set->copies[m_frameIndex];
+
+  if (m_descriptorBuffer.address)
+    context->setDescriptorBufferOffset(cmd, bindPoint, layout, index, allocation.offset);
+  else
+    cmd.bindDescriptorSets(bindPoint, layout, index, allocation.set, nullptr);
+}
+
 vk::SurfaceFormatKHR Renderer::checkFormat(const VulkanContext * context, Settings& settings) const {
   std::vector<vk::SurfaceFormatKHR> formats = context->gpu().getSurfaceFormatsKHR(context->surface());
   for (const auto& format : formats) {
@@ -1,50 +1,110 @@
+#include "src/include/hash.hpp"
 #include "src/include/log.hpp"
 #include "src/include/shader_compiler.hpp"
 
+#include <glslang/build_info.h>
+
+#include <filesystem>
 #include <fstream>
 #include <format>
+#include <iterator>
+#include <thread>
 
 namespace groot {
 
-ShaderCompiler::ShaderCompiler() {
-  m_opts.SetOptimizationLevel(shaderc_optimization_level_performance);
-  m_opts.SetTargetEnvironment(shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_4);
-}
-
-std::vector<unsigned int> ShaderCompiler::compileShader(ShaderType type, const std::string& path) const {
-  std::string source = stringify(path);
-  if (source == "") return {};
+namespace {
 
-  shaderc_shader_kind shaderKind;
+shaderc_shader_kind shaderKind(ShaderType type) {
   switch (type) {
     case ShaderType::Vertex:
-      shaderKind = shaderc_vertex_shader;
-      break;
+      return shaderc_vertex_shader;
     case ShaderType::Fragment:
-      shaderKind = shaderc_fragment_shader;
-      break;
+      return shaderc_fragment_shader;
     case ShaderType::TesselationControl:
-      shaderKind = shaderc_tess_control_shader;
-      break;
+      return shaderc_tess_control_shader;
     case ShaderType::TesselationEvaluation:
-      shaderKind = shaderc_tess_evaluation_shader;
-      break;
+      return shaderc_tess_evaluation_shader;
     case ShaderType::Compute:
-      shaderKind = shaderc_compute_shader;
+      return shaderc_compute_shader;
   }
 
-  auto res = m_compiler.CompileGlslToSpv(source, shaderKind, path.c_str());
-  if (res.GetNumErrors() > 0) {
-    Log::warn(std::format("\033[31mfailed to compile {}:\033[0m\n{}", path, res.GetErrorMessage()));
-    return {};
-  }
-  if (res.GetNumWarnings() > 0)
-    Log::warn(std::format("warning generated while compiling {}:\033[0m\n{}", path, res.GetErrorMessage()));
+  return shaderc_glsl_infer_from_source;
+}
 
-  return std::vector<unsigned int>(res.begin(), res.end());
+shaderc::Compiler& compiler() {
+  thread_local shaderc::Compiler compiler;
+  return compiler;
 }
 
-std::string ShaderCompiler::stringify(const std::string& path) const {
+class Includer : public shaderc::CompileOptions::IncluderInterface {
+  struct Include {
+    shaderc_include_result result;
+    std::string name;
+    std::string content;
+  };
+
+  const std::vector<std::string>& m_directories;
+  std::vector<std::string>& m_includes;
+
+  public:
+    Includer(const std::vector<std::string>& directories, std::vector<std::string>& includes)
+    : m_directories(directories), m_includes(includes) {}
+
+    shaderc_include_result * GetInclude(const char * requested, shaderc_include_type type, const char * requesting, std::size_t) override {
+      std::vector<std::filesystem::path> candidates;
+      if (type == shaderc_include_type_relative)
+        candidates.emplace_back(std::filesystem::path(requesting).parent_path() / requested);
+      for (const auto& directory : m_directories)
+        candidates.emplace_back(std::filesystem::path(directory) / requested);
+
+      Include * include = new Include;
+      for (const auto& candidate : candidates) {
+        std::ifstream file(candidate);
+        if (!file) continue;
+
+        include->name = candidate.string();
+        include->content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        m_includes.emplace_back(include->name);
+        break;
+      }
+
+      if (include->name.empty())
+        include->content = std::format("failed to resolve #include \"{}\"", requested);
+
+      include->result = shaderc_include_result{
+        .source_name        = include->name.data(),
+        .source_name_length = include->name.size(),
+        .content            = include->content.data(),
+        .content_length     = include->content.size(),
+        .user_data          = include
+      };
+
+      return &include->result;
+    }
+
+    void ReleaseInclude(shaderc_include_result * result) override {
+      delete static_cast<Include *>(result->user_data);
+    }
+};
+
+} // namespace
+
+ShaderCompiler::ShaderCompiler(const std::string& cacheDirectory, const std::vector<std::string>& includeDirectories)
+: m_cacheDirectory(cacheDirectory), m_includeDirectories(includeDirectories) {
+  m_opts.SetOptimizationLevel(shaderc_optimization_level_performance);
+  m_opts.SetTargetEnvironment(shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_4);
+
+  if (m_cacheDirectory.empty()) return;
+
+  std::error_code error;
+  std::filesystem::create_directories(m_cacheDirectory, error);
+  if (error) {
+    Log::warn(std::format("failed to create shader cache directory {}: {}. shader caching is disabled", m_cacheDirectory, error.message()));
+    m_cacheDirectory.clear();
+  }
+}
+
+std::string ShaderCompiler::readSource(const std::string& path) const {
   std::ifstream file(path);
   if (!file) {
     Log::warn(std::format("{} not found", path));
@@ -59,4 +119,92 @@ std::string ShaderCompiler::stringify(const std::string& path) const {
   return source;
 }
 
-} // namespace groot
\ No newline at end of file
+PreprocessedShader ShaderCompiler::preprocess(ShaderType type, const std::string& path, const std::string& source, const std::vector<ShaderDefine>& defines) const {
+  PreprocessedShader shader;
+
+  shaderc::CompileOptions opts(m_opts);
+  opts.SetIncluder(std::make_unique<Includer>(m_includeDirectories, shader.includes));
+  for (const auto& define : defines)
+    opts.AddMacroDefinition(define.name, define.value);
+
+  auto res = compiler().PreprocessGlsl(source, shaderKind(type), path.c_str(), opts);
+  if (res.GetNumErrors() > 0) {
+    Log::warn(std::format("\033[31mfailed to preprocess {}:\033[0m\n{}", path, res.GetErrorMessage()));
+    return {};
+  }
+
+  shader.source.assign(res.cbegin(), res.cend());
+  return shader;
+}
+
+unsigned long ShaderCompiler::cacheKey(ShaderType type, const std::string& source) const {
+  unsigned long key = fnv1a(source);
+  key = fnv1aValue(type, key);
+  key = fnv1aValue(shaderc_optimization_level_performance, key);
+  key = fnv1aValue(shaderc_env_version_vulkan_1_4, key);
+  key = fnv1a(std::string_view(GROOT_SHADERC_VERSION), key);
+  key = fnv1a(std::format("{}.{}.{}{}", GLSLANG_VERSION_MAJOR, GLSLANG_VERSION_MINOR, GLSLANG_VERSION_PATCH, GLSLANG_VERSION_FLAVOR), key);
+
+  return fnv1a(std::format("{}.{}.{}", GROOT_VERSION_MAJOR, GROOT_VERSION_MINOR, GROOT_VERSION_PATCH), key);
+}
+
+std::vector<unsigned int> ShaderCompiler::compileShader(ShaderType type, const std::string& path, const std::string& source, unsigned long key) const {
+  std::vector<unsigned int> cached = loadCached(key);
+  if (!cached.empty()) return cached;
+
+  auto res = compiler().CompileGlslToSpv(source, shaderKind(type), path.c_str(), m_opts);
+  if (res.GetNumErrors() > 0) {
+    Log::warn(std::format("\033[31mfailed to compile {}:\033[0m\n{}", path, res.GetErrorMessage()));
+    return {};
+  }
+  if (res.GetNumWarnings() > 0)
+    Log::warn(std::format("warning generated while compiling {}:\033[0m\n{}", path, res.GetErrorMessage()));
+
+  std::vector<unsigned int> code(res.begin(), res.end());
+  storeCached(key, code);
+
+  return code;
+}
+
+std::vector<unsigned int> ShaderCompiler::loadCached(unsigned long key) const {
+  if (m_cacheDirectory.empty()) return {};
+
+  std::ifstream file(std::format("{}/{:016x}.spv", m_cacheDirectory, key), std::ios::binary | std::ios::ate);
+  if (!file) return {};
+
+  std::size_t size = file.tellg();
+  if (size == 0 || size % sizeof(unsigned int) != 0) return {};
+
+  std::vector<unsigned int> code(size / sizeof(unsigned int));
+  file.seekg(0);
+  if (!file.read(reinterpret_cast<char *>(code.data()), size)) return {};
+
+  if (code[0] != 0x07230203) return {};
+
+  return code;
+}
+
+void ShaderCompiler::storeCached(unsigned long key, const std::vector<unsigned int>& code) const {
+  if (m_cacheDirectory.empty()) return;
+
+  std::string path = std::format("{}/{:016x}.spv", m_cacheDirectory, key);
+  std::string tmpPath = std::format("{}.{}.tmp", path, std::hash<std::thread::id>{}(std::this_thread::get_id()));
+
+  {
+    std::ofstream file(tmpPath, std::ios::binary);
+    if (!file) {
+      Log::warn(std::format("failed to write shader cache entry {}", path));
+      return;
+    }
+    file.write(reinterpret_cast<const char *>(code.data()), code.size() * sizeof(unsigned int));
+  }
+
+  std::error_code error;
+  std::filesystem::rename(tmpPath, path, error);
+  if (error) {
+    Log::warn(std::format("failed to write shader cache entry {}: {}", path, error.message()));
+    std::filesystem::remove(tmpPath, error);
+  }
+}
+
+} // namespace groot
@@ -0,0 +1,304 @@
+#include "src/include/shader_reflection.hpp"
+
+#include <algorithm>
+#include <tuple>
+#include <unordered_map>
+
+namespace groot {
+
+namespace {
+
+enum Op : unsigned int {
+  OpEntryPoint        = 15,
+  OpTypeBool          = 20,
+  OpTypeInt           = 21,
+  OpTypeFloat         = 22,
+  OpTypeVector        = 23,
+  OpTypeMatrix        = 24,
+  OpTypeImage         = 25,
+  OpTypeSampler       = 26,
+  OpTypeSampledImage  = 27,
+  OpTypeArray         = 28,
+  OpTypeRuntimeArray  = 29,
+  OpTypeStruct        = 30,
+  OpTypePointer       = 32,
+  OpConstant          = 43,
+  OpSpecConstantTrue  = 48,
+  OpSpecConstantFalse = 49,
+  OpSpecConstant      = 50,
+  OpVariable          = 59,
+  OpDecorate          = 71,
+  OpMemberDecorate    = 72
+};
+
+enum Decoration : unsigned int {
+  SpecId        = 1,
+  BufferBlock   = 3,
+  ArrayStride   = 6,
+  MatrixStride  = 7,
+  Binding       = 33,
+  DescriptorSet = 34,
+  Offset        = 35
+};
+
+enum StorageClass : unsigned int {
+  UniformConstant = 0,
+  Uniform         = 2,
+  PushConstant    = 9,
+  StorageBuffer   = 12
+};
+
+struct Type {
+  unsigned int op = 0;
+  std::vector<unsigned int> operands;
+};
+
+struct Decorations {
+  unsigned int set = 0;
+  unsigned int binding = 0;
+  unsigned int arrayStride = 0;
+  int specId = -1;
+  bool bufferBlock = false;
+  std::unordered_map<unsigned int, unsigned int> memberOffsets;
+  std::unordered_map<unsigned int, unsigned int> memberMatrixStrides;
+};
+
+struct Module {
+  std::unordered_map<unsigned int, Type> types;
+  std::unordered_map<unsigned int, unsigned int> constants;
+  std::unordered_map<unsigned int, Decorations> decorations;
+
+  unsigned int size(unsigned int id) const {
+    auto it = types.find(id);
+    if (it == types.end()) return 0;
+
+    const auto& [op, operands] = it->second;
+    switch (op) {
+      case OpTypeBool:
+        return 4;
+      case OpTypeInt:
+      case OpTypeFloat:
+        return operands[0] / 8;
+      case OpTypeVector:
+        return operands[1] * size(operands[0]);
+      case OpTypeMatrix:
+        return operands[1] * size(operands[0]);
+      case OpTypeArray: {
+        unsigned int length = constants.contains(operands[1]) ? constants.at(operands[1]) : 0;
+        unsigned int stride = decoration(id).arrayStride;
+        return length * (stride != 0 ? stride : size(operands[0]));
+      }
+      case OpTypeStruct: {
+        const Decorations& decorated = decoration(id);
+
+        unsigned int end = 0;
+        for (unsigned int member = 0; member < operands.size(); ++member) {
+          unsigned int offset = decorated.memberOffsets.contains(member) ? decorated.memberOffsets.at(member) : end;
+          unsigned int memberSize = size(operands[member]);
+
+          auto memberType = types.find(operands[member]);
+          if (memberType != types.end() && memberType->second.op == OpTypeMatrix && decorated.memberMatrixStrides.contains(member))
+            memberSize = memberType->second.operands[1] * decorated.memberMatrixStrides.at(member);
+
+          end = std::max(end, offset + memberSize);
+        }
+
+        return end;
+      }
+      default:
+        return 0;
+    }
+  }
+
+  const Decorations& decoration(unsigned int id) const {
+    static const Decorations none;
+    auto it = decorations.find(id);
+    return it == decorations.end() ? none : it->second;
+  }
+};
+
+vk::ShaderStageFlags executionStage(unsigned int model) {
+  switch (model) {
+    case 0: return vk::ShaderStageFlagBits::eVertex;
+    case 1: return vk::ShaderStageFlagBits::eTessellationControl;
+    case 2: return vk::ShaderStageFlagBits::eTessellationEvaluation;
+    case 3: return vk::ShaderStageFlagBits::eGeometry;
+    case 4: return vk::ShaderStageFlagBits::eFragment;
+    case 5: return vk::ShaderStageFlagBits::eCompute;
+    default: return {};
+  }
+}
+
+} // namespace
+
+ShaderReflection reflectShader(const std::vector<unsigned int>& code) {
+  ShaderReflection reflection;
+  if (code.size() < 5 || code[0] != 0x07230203) return reflection;
+
+  Module module;
+  std::vector<std::pair<unsigned int, unsigned int>> variables;
+  std::vector<std::pair<unsigned int, unsigned int>> specConstants;
+  std::unordered_map<unsigned int, unsigned int> variableTypes;
+
+  for (std::size_t i = 5; i < code.size();) {
+    unsigned int count = code[i] >> 16;
+    unsigned int op = code[i] & 0xffff;
+    if (count == 0 || i + count > code.size()) break;
+
+    const unsigned int * words = &code[i + 1];
+    switch (op) {
+      case OpEntryPoint:
+        reflection.stage |= executionStage(words[0]);
+        break;
+      case OpTypeBool:
+      case OpTypeInt:
+      case OpTypeFloat:
+      case OpTypeVector:
+      case OpTypeMatrix:
+      case OpTypeImage:
+      case OpTypeSampler:
+      case OpTypeSampledImage:
+      case OpTypeArray:
+      case OpTypeRuntimeArray:
+      case OpTypeStruct:
+      case OpTypePointer:
+        module.types[words[0]] = Type{ op, std::vector<unsigned int>(words + 1, words + count - 1) };
+        break;
+      case OpConstant:
+        if (count >= 4) module.constants[words[1]] = words[2];
+        break;
+      case OpSpecConstantTrue:
+      case OpSpecConstantFalse:
+      case OpSpecConstant:
+        specConstants.emplace_back(words[1], words[0]);
+        break;
+      case OpVariable:
+        variables.emplace_back(words[1], words[2]);
+        variableTypes[words[1]] = words[0];
+        break;
+      case OpDecorate: {
+        Decorations& decorated = module.decorations[words[0]];
+        switch (words[1]) {
+          case BufferBlock:   decorated.bufferBlock = true; break;
+          case SpecId:        decorated.specId = words[2]; break;
+          case ArrayStride:   decorated.arrayStride = words[2]; break;
+          case Binding:       decorated.binding = words[2]; break;
+          case DescriptorSet: decorated.set = words[2]; break;
+        }
+        break;
+      }
+      case OpMemberDecorate: {
+        Decorations& decorated = module.decorations[words[0]];
+        if (words[2] == Offset) decorated.memberOffsets[words[1]] = words[3];
+        if (words[2] == MatrixStride) decorated.memberMatrixStrides[words[1]] = words[3];
+        break;
+      }
+    }
+
+    i += count;
+  }
+
+  for (const auto& [id, storage] : variables) {
+    auto pointer = module.types.find(variableTypes.at(id));
+    if (pointer == module.types.end() || pointer->second.op != OpTypePointer) continue;
+
+    unsigned int typeId = pointer->second.operands[1];
+
+    if (storage == PushConstant) {
+      reflection.pushConstantSize = std::max(reflection.pushConstantSize, module.size(typeId));
+      continue;
+    }
+
+    if (storage != UniformConstant && storage != Uniform && storage != StorageBuffer) continue;
+
+    unsigned int descriptorCount = 1;
+    auto type = module.types.find(typeId);
+    if (type != module.types.end() && type->second.op == OpTypeArray) {
+      descriptorCount = module.constants.contains(type->second.operands[1]) ? module.constants.at(type->second.operands[1]) : 1;
+      typeId = type->second.operands[0];
+      type = module.types.find(typeId);
+    }
+    else if (type != module.types.end() && type->second.op == OpTypeRuntimeArray) {
+      descriptorCount = 0;
+      typeId = type->second.operands[0];
+      type = module.types.find(typeId);
+    }
+    if (type == module.types.end()) continue;
+
+    vk::DescriptorType descriptorType;
+    if (storage == StorageBuffer)
+      descriptorType = vk::DescriptorType::eStorageBuffer;
+    else if (storage == Uniform)
+      descriptorType = module.decoration(typeId).bufferBlock ? vk::DescriptorType::eStorageBuffer : vk::DescriptorType::eUniformBuffer;
+    else if (type->second.op == OpTypeSampledImage)
+      descriptorType = vk::DescriptorType::eCombinedImageSampler;
+    else if (type->second.op == OpTypeSampler)
+      descriptorType = vk::DescriptorType::eSampler;
+    else if (type->second.op == OpTypeImage) {
+      bool texelBuffer = type->second.operands[1] == 5;
+      bool storageImage = type->second.operands[5] == 2;
+      if (texelBuffer)
+        descriptorType = storageImage ? vk::DescriptorType::eStorageTexelBuffer : vk::DescriptorType::eUniformTexelBuffer;
+      else if (type->second.operands[1] == 6)
+        descriptorType = vk::DescriptorType::eInputAttachment;
+      else
+        descriptorType = storageImage ? vk::DescriptorType::eStorageImage : vk::DescriptorType::eSampledImage;
+    }
+    else continue;
+
+    const Decorations& decorated = module.decoration(id);
+    reflection.bindings.emplace_back(ReflectedBinding{
+      .set      = decorated.set,
+      .binding  = decorated.binding,
+      .type     = descriptorType,
+      .count    = descriptorCount,
+      .stages   = reflection.stage
+    });
+  }
+
+  for (const auto& [id, type] : specConstants) {
+    int specId = module.decoration(id).specId;
+    if (specId >= 0)
+      reflection.specializationConstants[specId] = module.size(type);
+  }
+
+  if (reflection.pushConstantSize > 0)
+    reflection.pushConstantStages = reflection.stage;
+
+  std::sort(reflection.bindings.begin(), reflection.bindings.end(), [](const auto& lhs, const auto& rhs) {
+    return std::tie(lhs.set, lhs.binding) < std::tie(rhs.set, rhs.binding);
+  });
+
+  return reflection;
+}
+
+bool mergeReflection(ShaderReflection& merged, const ShaderReflection& reflection) {
+  merged.stage |= reflection.stage;
+  merged.pushConstantSize = std::max(merged.pushConstantSize, reflection.pushConstantSize);
+  merged.pushConstantStages |= reflection.pushConstantStages;
+  merged.specializationConstants.insert(reflection.specializationConstants.begin(), reflection.specializationConstants.end());
+
+  bool compatible = true;
+  for (const auto& binding : reflection.bindings) {
+    auto it = std::find_if(merged.bindings.begin(), merged.bindings.end(), [&binding](const auto& existing) {
+      return existing.set == binding.set && existing.binding == binding.binding;
+    });
+
+    if (it == merged.bindings.end()) {
+      merged.bindings.emplace_back(binding);
+      continue;
+    }
+
+    compatible &= it->type == binding.type;
+    it->stages |= binding.stages;
+    it->count = std::max(it->count, binding.count);
+  }
+
+  std::sort(merged.bindings.begin(), merged.bindings.end(), [](const auto& lhs, const auto& rhs) {
+    return std::tie(lhs.set, lhs.binding) < std::tie(rhs.set, rhs.binding);
+  });
+
+  return compatible;
+}
+
+} // namespace groot
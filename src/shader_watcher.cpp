@@ -0,0 +1,115 @@
+#include "src/include/log.hpp"
+#include "src/include/shader_watcher.hpp"
+
+#include <chrono>
+#include <format>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace groot {
+
+ShaderWatcher::ShaderWatcher() {
+#ifdef __linux__
+  m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (m_fd < 0)
+    Log::warn("failed to initialize inotify. falling back to polling shader files");
+#endif
+
+  m_thread = std::thread(&ShaderWatcher::work, this);
+}
+
+ShaderWatcher::~ShaderWatcher() {
+  m_stop = true;
+  m_thread.join();
+
+#ifdef __linux__
+  if (m_fd >= 0) close(m_fd);
+#endif
+}
+
+void ShaderWatcher::watch(const std::string& path) {
+  std::error_code error;
+  std::filesystem::path file = std::filesystem::weakly_canonical(path, error);
+  if (error) return;
+
+  std::lock_guard lock(m_mutex);
+  if (m_files.contains(file.string())) return;
+
+  m_files[file.string()] = std::filesystem::last_write_time(file, error);
+
+#ifdef __linux__
+  if (m_fd < 0) return;
+
+  std::string directory = file.parent_path().string();
+  for (const auto& [wd, watched] : m_directories) {
+    if (watched == directory) return;
+  }
+
+  int wd = inotify_add_watch(m_fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+  if (wd < 0) {
+    Log::warn(std::format("failed to watch {} for shader changes", directory));
+    return;
+  }
+  m_directories[wd] = directory;
+#endif
+}
+
+std::vector<std::string> ShaderWatcher::changed() {
+  std::lock_guard lock(m_mutex);
+
+  std::vector<std::string> paths(m_changed.begin(), m_changed.end());
+  m_changed.clear();
+
+  return paths;
+}
+
+void ShaderWatcher::work() {
+  while (!m_stop) {
+#ifdef __linux__
+    if (m_fd >= 0) {
+      pollfd descriptor{ .fd = m_fd, .events = POLLIN };
+      if (::poll(&descriptor, 1, 100) <= 0) continue;
+
+      alignas(inotify_event) char buffer[4096];
+      ssize_t length = 0;
+      while ((length = read(m_fd, buffer, sizeof(buffer))) > 0) {
+        std::lock_guard lock(m_mutex);
+
+        for (char * ptr = buffer; ptr < buffer + length;) {
+          const inotify_event * event = reinterpret_cast<const inotify_event *>(ptr);
+          ptr += sizeof(inotify_event) + event->len;
+
+          if (event->len == 0 || !m_directories.contains(event->wd)) continue;
+
+          std::string file = (std::filesystem::path(m_directories.at(event->wd)) / event->name).string();
+          if (m_files.contains(file))
+            m_changed.emplace(file);
+        }
+      }
+      continue;
+    }
+#endif
+
+    poll();
+    std::this_thread::sleep_for(std::chrono::milliseconds(250));
+  }
+}
+
+void ShaderWatcher::poll() {
+  std::lock_guard lock(m_mutex);
+
+  for (auto& [file, time] : m_files) {
+    std::error_code error;
+    std::filesystem::file_time_type current = std::filesystem::last_write_time(file, error);
+    if (error || current == time) continue;
+
+    time = current;
+    m_changed.emplace(file);
+  }
+}
+
+} // namespace groot
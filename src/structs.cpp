@@ -29,39 +29,20 @@ std::size_t Vertex::Hash::operator()(const Vertex& v) const {
   return posHash ^ texHash ^ normHash;
 }
 
-bool Vertex::operator==(const Vertex& rhs) const {
-  return position == rhs.position && uv == rhs.uv && normal == rhs.normal;
-}
+std::size_t SamplerSettings::Hash::operator()(const SamplerSettings& s) const {
+  std::hash<int> intHash{};
 
-vk::VertexInputBindingDescription Vertex::binding() {
-  return vk::VertexInputBindingDescription{
-    .binding    = 0,
-    .stride     = sizeof(Vertex),
-    .inputRate  = vk::VertexInputRate::eVertex
-  };
+  std::size_t filterHash = intHash(static_cast<int>(s.mag_filter)) ^ (intHash(static_cast<int>(s.min_filter)) << 1);
+  std::size_t modeHash = (intHash(static_cast<int>(s.mode_u)) ^ (intHash(static_cast<int>(s.mode_v)) << 2)) ^ (intHash(static_cast<int>(s.mode_w)) << 4);
+  std::size_t lodHash = std::hash<float>{}(s.mip_lod_bias);
+  std::size_t compareHash = intHash(static_cast<int>(s.compare_op)) ^ (intHash(s.enable_compare) << 3);
+  std::size_t borderHash = intHash(static_cast<int>(s.border_color)) ^ (intHash(s.anisotropic_filtering) << 3);
+
+  return filterHash ^ (modeHash << 1) ^ (lodHash << 2) ^ (compareHash << 3) ^ (borderHash << 4);
 }
 
-std::array<vk::VertexInputAttributeDescription, 3> Vertex::attributes() {
-  return {
-    vk::VertexInputAttributeDescription{
-      .location = 0,
-      .binding  = 0,
-      .format   = vk::Format::eR32G32B32Sfloat,
-      .offset   = offsetof(Vertex, position)
-    },
-    vk::VertexInputAttributeDescription{
-      .location = 1,
-      .binding  = 0,
-      .format   = vk::Format::eR32G32Sfloat,
-      .offset   = offsetof(Vertex, uv)
-    },
-    vk::VertexInputAttributeDescription{
-      .location = 2,
-      .binding  = 0,
-      .format   = vk::Format::eR32G32B32Sfloat,
-      .offset   = offsetof(Vertex, normal)
-    }
-  };
+bool Vertex::operator==(const Vertex& rhs) const {
+  return position == rhs.position && uv == rhs.uv && normal == rhs.normal;
 }
 
 mat4 Transform::matrix() const {
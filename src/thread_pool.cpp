@@ -0,0 +1,45 @@
+#include "src/include/thread_pool.hpp"
+
+#include <algorithm>
+
+namespace groot {
+
+ThreadPool::ThreadPool(unsigned int threads) {
+  if (threads == 0)
+    threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+  m_threads.reserve(threads);
+  for (unsigned int i = 0; i < threads; ++i)
+    m_threads.emplace_back(&ThreadPool::work, this);
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard lock(m_mutex);
+    m_stop = true;
+  }
+  m_taskReady.notify_all();
+
+  for (auto& thread : m_threads)
+    thread.join();
+}
+
+unsigned int ThreadPool::size() const {
+  return m_threads.size();
+}
+
+void ThreadPool::work() {
+  while (true) {
+    std::unique_lock lock(m_mutex);
+    m_taskReady.wait(lock, [this] { return m_stop || !m_tasks.empty(); });
+    if (m_tasks.empty()) return;
+
+    std::function<void()> task = std::move(m_tasks.front());
+    m_tasks.pop_front();
+    lock.unlock();
+
+    task();
+  }
+}
+
+} // namespace groot
@@ -0,0 +1,147 @@
+#include "src/include/hash.hpp"
+#include "src/include/structs.hpp"
+#include "src/include/vertex_layout.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+
+namespace groot {
+
+namespace {
+
+unsigned short toHalf(float value) {
+  unsigned int bits = std::bit_cast<unsigned int>(value);
+  unsigned int sign = (bits >> 16) & 0x8000;
+  int exponent = static_cast<int>((bits >> 23) & 0xFF) - 127 + 15;
+  unsigned int mantissa = bits & 0x7FFFFF;
+
+  if (((bits >> 23) & 0xFF) == 0xFF) return sign | 0x7C00 | (mantissa ? 0x200 : 0);
+  if (exponent >= 31) return sign | 0x7C00;
+
+  if (exponent <= 0) {
+    if (exponent < -10) return sign;
+
+    mantissa |= 0x800000;
+    unsigned int shift = 14 - exponent;
+    unsigned int half = mantissa >> shift;
+    unsigned int rest = mantissa & ((1u << shift) - 1);
+    unsigned int midpoint = 1u << (shift - 1);
+    if (rest > midpoint || (rest == midpoint && (half & 1))) ++half;
+
+    return sign | half;
+  }
+
+  unsigned int half = (exponent << 10) | (mantissa >> 13);
+  unsigned int rest = mantissa & 0x1FFF;
+  if (rest > 0x1000 || (rest == 0x1000 && (half & 1))) ++half;
+
+  return sign | half;
+}
+
+short toSnorm16(float value) {
+  return static_cast<short>(std::round(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+}
+
+unsigned short toUnorm16(float value) {
+  return static_cast<unsigned short>(std::round(std::clamp(value, 0.0f, 1.0f) * 65535.0f));
+}
+
+signed char toSnorm8(float value) {
+  return static_cast<signed char>(std::round(std::clamp(value, -1.0f, 1.0f) * 127.0f));
+}
+
+vec2 octahedral(const vec3& normal) {
+  float length = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+  if (length == 0.0f) return vec2(0.0f, 0.0f);
+
+  vec2 projected(normal.x / length, normal.y / length);
+  if (normal.z >= 0.0f) return projected;
+
+  return vec2(
+    (1.0f - std::abs(projected.y)) * (projected.x >= 0.0f ? 1.0f : -1.0f),
+    (1.0f - std::abs(projected.x)) * (projected.y >= 0.0f ? 1.0f : -1.0f)
+  );
+}
+
+template <typename T>
+void write(unsigned char *& dst, T value) {
+  std::memcpy(dst, &value, sizeof(T));
+  dst += sizeof(T);
+}
+
+void encode(unsigned char * dst, VertexEncoding encoding, const float * values, unsigned int components, float padding) {
+  unsigned int stored = components == 3 && encoding != VertexEncoding::Float32 ? 4 : components;
+
+  for (unsigned int i = 0; i < stored; ++i) {
+    float value = i < components ? values[i] : padding;
+
+    switch (encoding) {
+      case VertexEncoding::Float32: write(dst, value); break;
+      case VertexEncoding::Float16: write(dst, toHalf(value)); break;
+      case VertexEncoding::Snorm16: write(dst, toSnorm16(value)); break;
+      case VertexEncoding::Unorm16: write(dst, toUnorm16(value)); break;
+      case VertexEncoding::Snorm8: write(dst, toSnorm8(value)); break;
+      case VertexEncoding::Octahedral16: write(dst, toSnorm16(value)); break;
+    }
+  }
+}
+
+} // namespace
+
+std::vector<unsigned char> encodeVertices(const VertexFormat& format, const std::vector<Vertex>& vertices, const vec3& offset, const vec3& scale) {
+  std::vector<unsigned char> data(static_cast<std::size_t>(format.stride) * vertices.size());
+
+  for (std::size_t v = 0; v < vertices.size(); ++v) {
+    const Vertex& vertex = vertices[v];
+
+    for (const auto& element : format.elements) {
+      unsigned char * dst = data.data() + v * format.stride + element.offset;
+
+      switch (element.attribute) {
+        case VertexAttribute::Position: {
+          vec3 position = vertex.position;
+          if (element.encoding == VertexEncoding::Snorm16)
+            position = vec3((position.x - offset.x) / scale.x, (position.y - offset.y) / scale.y, (position.z - offset.z) / scale.z);
+
+          float values[3] = { position.x, position.y, position.z };
+          encode(dst, element.encoding, values, 3, 1.0f);
+          break;
+        }
+        case VertexAttribute::UV: {
+          float values[2] = { vertex.uv.x, vertex.uv.y };
+          encode(dst, element.encoding, values, 2, 0.0f);
+          break;
+        }
+        case VertexAttribute::Normal: {
+          if (element.encoding == VertexEncoding::Octahedral16) {
+            vec2 encoded = octahedral(vertex.normal);
+            float values[2] = { encoded.x, encoded.y };
+            encode(dst, element.encoding, values, 2, 0.0f);
+            break;
+          }
+
+          float values[3] = { vertex.normal.x, vertex.normal.y, vertex.normal.z };
+          encode(dst, element.encoding, values, 3, 0.0f);
+          break;
+        }
+      }
+    }
+  }
+
+  return data;
+}
+
+unsigned long vertexFormatKey(const VertexFormat& format, unsigned long key) {
+  key = fnv1aValue(format.stride, key);
+  for (const auto& element : format.elements) {
+    key = fnv1aValue(element.attribute, key);
+    key = fnv1aValue(element.encoding, key);
+    key = fnv1aValue(element.offset, key);
+  }
+
+  return key;
+}
+
+} // namespace groot
@@ -1,10 +1,14 @@
 #include "src/include/log.hpp"
+#include "src/include/structs.hpp"
 #include "vulkan/vulkan.hpp"
 #include "src/include/vulkan_context.hpp"
 
 #include <vulkan/vulkan_beta.h>
 #include <GLFW/glfw3.h>
 
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <set>
 
 #define GRAPHICS_SHIFT  0
@@ -59,6 +63,8 @@ VulkanContext::VulkanContext(const std::string& applicationName, const unsigned
 }
 
 VulkanContext::~VulkanContext() {
+  savePipelineCache();
+  m_device.destroyPipelineCache(m_pipelineCache);
   m_device.destroyDescriptorPool(m_guiDescriptorPool);
   m_device.destroyCommandPool(m_transferCmdPool);
   m_device.destroyCommandPool(m_computeCmdPool);
@@ -163,6 +169,127 @@ bool VulkanContext::supportsAnisotropy() const {
   return m_gpu.getFeatures().samplerAnisotropy;
 }
 
+bool VulkanContext::supportsDynamicState() const {
+  return m_dynamicState;
+}
+
+bool VulkanContext::supportsDynamicBlend() const {
+  return m_dynamicBlend;
+}
+
+bool VulkanContext::supportsPipelineLibraries() const {
+  return m_pipelineLibraries;
+}
+
+bool VulkanContext::supportsBindless() const {
+  return m_bindless;
+}
+
+bool VulkanContext::supportsPushDescriptors() const {
+  return m_cmdPushDescriptorSet != nullptr;
+}
+
+unsigned int VulkanContext::maxPushDescriptors() const {
+  return m_maxPushDescriptors;
+}
+
+bool VulkanContext::supportsDescriptorBuffers() const {
+  return m_descriptorBuffers;
+}
+
+const vk::PhysicalDeviceDescriptorBufferPropertiesEXT& VulkanContext::descriptorBufferProperties() const {
+  return m_descriptorBufferProperties;
+}
+
+vk::PipelineCreateFlags VulkanContext::pipelineCreateFlags() const {
+  return m_descriptorBuffers ? vk::PipelineCreateFlagBits::eDescriptorBufferEXT : vk::PipelineCreateFlags();
+}
+
+void VulkanContext::setColorBlendEnable(const vk::CommandBuffer& cmd, bool enable) const {
+  VkBool32 value = enable;
+  m_cmdSetColorBlendEnable(cmd, 0, 1, &value);
+}
+
+void VulkanContext::pushDescriptorSet(
+  const vk::CommandBuffer& cmd,
+  vk::PipelineBindPoint bindPoint,
+  const vk::PipelineLayout& layout,
+  const std::vector<vk::WriteDescriptorSet>& writes
+) const {
+  m_cmdPushDescriptorSet(
+    cmd,
+    static_cast<VkPipelineBindPoint>(bindPoint),
+    layout,
+    0,
+    static_cast<unsigned int>(writes.size()),
+    reinterpret_cast<const VkWriteDescriptorSet *>(writes.data())
+  );
+}
+
+vk::DeviceSize VulkanContext::descriptorSetLayoutSize(const vk::DescriptorSetLayout& layout) const {
+  VkDeviceSize size = 0;
+  m_getDescriptorSetLayoutSize(m_device, layout, &size);
+  return size;
+}
+
+vk::DeviceSize VulkanContext::descriptorBindingOffset(const vk::DescriptorSetLayout& layout, unsigned int binding) const {
+  VkDeviceSize offset = 0;
+  m_getDescriptorSetLayoutBindingOffset(m_device, layout, binding, &offset);
+  return offset;
+}
+
+void VulkanContext::getDescriptor(const vk::DescriptorGetInfoEXT& info, std::size_t size, void * descriptor) const {
+  m_getDescriptor(m_device, reinterpret_cast<const VkDescriptorGetInfoEXT *>(&info), size, descriptor);
+}
+
+void VulkanContext::bindDescriptorBuffer(const vk::CommandBuffer& cmd, const vk::DescriptorBufferBindingInfoEXT& info) const {
+  m_cmdBindDescriptorBuffers(cmd, 1, reinterpret_cast<const VkDescriptorBufferBindingInfoEXT *>(&info));
+}
+
+void VulkanContext::setDescriptorBufferOffset(
+  const vk::CommandBuffer& cmd,
+  vk::PipelineBindPoint bindPoint,
+  const vk::PipelineLayout& layout,
+  unsigned int set,
+  vk::DeviceSize offset
+) const {
+  unsigned int buffer = 0;
+  VkDeviceSize bufferOffset = offset;
+  m_cmdSetDescriptorBufferOffsets(cmd, static_cast<VkPipelineBindPoint>(bindPoint), layout, set, 1, &buffer, &bufferOffset);
+}
+
+const vk::PipelineCache& VulkanContext::pipelineCache() const {
+  return m_pipelineCache;
+}
+
+void VulkanContext::savePipelineCache() const {
+  if (!m_pipelineCache || m_pipelineCachePath.empty()) return;
+
+  std::vector<unsigned char> data = m_device.getPipelineCacheData(m_pipelineCache);
+  if (data.empty()) return;
+
+  std::error_code error;
+  std::filesystem::path path(m_pipelineCachePath);
+  if (path.has_parent_path())
+    std::filesystem::create_directories(path.parent_path(), error);
+
+  std::string tmpPath = std::format("{}.tmp", m_pipelineCachePath);
+  {
+    std::ofstream file(tmpPath, std::ios::binary);
+    if (!file) {
+      Log::warn(std::format("failed to write pipeline cache {}", m_pipelineCachePath));
+      return;
+    }
+    file.write(reinterpret_cast<const char *>(data.data()), data.size());
+  }
+
+  std::filesystem::rename(tmpPath, m_pipelineCachePath, error);
+  if (error) {
+    Log::warn(std::format("failed to write pipeline cache {}: {}", m_pipelineCachePath, error.message()));
+    std::filesystem::remove(tmpPath, error);
+  }
+}
+
 void VulkanContext::createSurface(GLFWwindow * window) {
   VkSurfaceKHR rawSurface = nullptr;
   if (glfwCreateWindowSurface(m_instance, window, nullptr, &rawSurface) != VK_SUCCESS)
@@ -206,19 +333,72 @@ void VulkanContext::chooseGPU(const unsigned int& gpuIndex, const std::vector<co
   m_queueFamilyIndices = getQueueFamilyIndices();
 }
 
-void VulkanContext::createDevice(std::vector<const char *>& extensions) {
+void VulkanContext::createDevice(std::vector<const char *>& extensions, const Settings& settings) {
   float queuePriority = 1.0f;
   std::vector<vk::DeviceQueueCreateInfo> queueCreateInfos = getQueueCreateInfos(queuePriority);
 
-  for (const auto& extension : m_gpu.enumerateDeviceExtensionProperties()) {
-    if (strcmp(extension.extensionName, VK_KHR_PORTABILITY_SUBSET_EXTENSION_NAME) != 0) continue;
+  std::set<std::string> available;
+  for (const auto& extension : m_gpu.enumerateDeviceExtensionProperties())
+    available.emplace(extension.extensionName);
 
+  if (available.contains(VK_KHR_PORTABILITY_SUBSET_EXTENSION_NAME)) {
     extensions.emplace_back(VK_KHR_PORTABILITY_SUBSET_EXTENSION_NAME);
-
     Log::generic("enabled portability subset");
-    break;
   }
 
+  vk::PhysicalDeviceExtendedDynamicState3FeaturesEXT supportedDynamicState3{};
+  vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT supportedDynamicState{};
+  vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT supportedPipelineLibrary{};
+  vk::PhysicalDeviceDescriptorIndexingFeatures supportedDescriptorIndexing{};
+  vk::PhysicalDeviceBufferDeviceAddressFeatures supportedDeviceAddress{};
+  vk::PhysicalDeviceDescriptorBufferFeaturesEXT supportedDescriptorBuffer{ .pNext = &supportedDeviceAddress };
+
+  auto query = [this, &available](const char * extension, void * feature) {
+    if (!available.contains(extension)) return false;
+
+    vk::PhysicalDeviceFeatures2 supportedFeatures2{ .pNext = feature };
+    m_gpu.getFeatures2(&supportedFeatures2);
+    return true;
+  };
+
+  bool coreDynamicState = m_gpu.getProperties().apiVersion >= VK_API_VERSION_1_3;
+  bool dynamicStateExtension = settings.dynamic_pipeline_state && query(VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME, &supportedDynamicState);
+  bool dynamicState3Extension = settings.dynamic_pipeline_state && query(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME, &supportedDynamicState3);
+  bool pipelineLibraryExtension = settings.graphics_pipeline_libraries &&
+    available.contains(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME) &&
+    query(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME, &supportedPipelineLibrary);
+  bool descriptorIndexingExtension = settings.bindless_descriptors && query(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME, &supportedDescriptorIndexing);
+  bool descriptorBufferExtension = settings.descriptor_buffers && m_gpu.getProperties().apiVersion >= VK_API_VERSION_1_2 &&
+    query(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME, &supportedDescriptorBuffer);
+
+  m_dynamicState = settings.dynamic_pipeline_state && (coreDynamicState || (dynamicStateExtension && supportedDynamicState.extendedDynamicState));
+  m_dynamicBlend = m_dynamicState && dynamicState3Extension && supportedDynamicState3.extendedDynamicState3ColorBlendEnable;
+  m_pipelineLibraries = pipelineLibraryExtension && supportedPipelineLibrary.graphicsPipelineLibrary;
+  m_bindless = descriptorIndexingExtension &&
+    supportedDescriptorIndexing.runtimeDescriptorArray &&
+    supportedDescriptorIndexing.descriptorBindingPartiallyBound &&
+    supportedDescriptorIndexing.descriptorBindingUpdateUnusedWhilePending &&
+    supportedDescriptorIndexing.descriptorBindingSampledImageUpdateAfterBind &&
+    supportedDescriptorIndexing.descriptorBindingStorageImageUpdateAfterBind &&
+    supportedDescriptorIndexing.descriptorBindingStorageBufferUpdateAfterBind &&
+    supportedDescriptorIndexing.shaderSampledImageArrayNonUniformIndexing;
+  m_descriptorBuffers = descriptorBufferExtension && supportedDescriptorBuffer.descriptorBuffer && supportedDeviceAddress.bufferDeviceAddress;
+
+  if (settings.dynamic_pipeline_state && !m_dynamicState)
+    Log::warn("GPU does not support extended dynamic state. pipelines will bake their rasterization state");
+  else if (settings.dynamic_pipeline_state && !m_dynamicBlend)
+    Log::warn("GPU does not support dynamic blend enable. pipelines will bake their blend state");
+
+  if (settings.descriptor_buffers && !m_descriptorBuffers)
+    Log::warn("GPU does not support descriptor buffers. descriptor sets will be allocated from pools");
+
+  if (m_bindless && m_descriptorBuffers) {
+    Log::warn("bindless descriptors are not available with descriptor buffers and are disabled");
+    m_bindless = false;
+  }
+  else if (settings.bindless_descriptors && !m_bindless)
+    Log::warn("GPU does not support descriptor indexing. bindless descriptors are disabled");
+
   vk::PhysicalDeviceFeatures supportedFeatures = m_gpu.getFeatures();
   vk::PhysicalDeviceFeatures features{
     .tessellationShader                   = supportedFeatures.tessellationShader,
@@ -232,6 +412,62 @@ void VulkanContext::createDevice(std::vector<const char *>& extensions) {
     .dynamicRendering = true
   };
 
+  vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT dynamicStateFeature{
+    .extendedDynamicState = true
+  };
+
+  vk::PhysicalDeviceExtendedDynamicState3FeaturesEXT dynamicState3Feature{
+    .extendedDynamicState3ColorBlendEnable = true
+  };
+
+  vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT pipelineLibraryFeature{
+    .graphicsPipelineLibrary = true
+  };
+
+  vk::PhysicalDeviceDescriptorBufferFeaturesEXT descriptorBufferFeature{
+    .descriptorBuffer = true
+  };
+
+  vk::PhysicalDeviceBufferDeviceAddressFeatures deviceAddressFeature{
+    .bufferDeviceAddress = true
+  };
+
+  auto enable = [&extensions, &dynamicRenderingFeature](const char * extension, auto& feature) {
+    extensions.emplace_back(extension);
+    feature.pNext = dynamicRenderingFeature.pNext;
+    dynamicRenderingFeature.pNext = &feature;
+  };
+
+  if (m_dynamicState && !coreDynamicState)
+    enable(VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME, dynamicStateFeature);
+  if (m_dynamicBlend)
+    enable(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME, dynamicState3Feature);
+  if (m_pipelineLibraries) {
+    extensions.emplace_back(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME);
+    enable(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME, pipelineLibraryFeature);
+  }
+  if (m_bindless)
+    enable(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME, supportedDescriptorIndexing);
+
+  if (m_descriptorBuffers) {
+    enable(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME, descriptorBufferFeature);
+    deviceAddressFeature.pNext = dynamicRenderingFeature.pNext;
+    dynamicRenderingFeature.pNext = &deviceAddressFeature;
+
+    vk::PhysicalDeviceProperties2 properties2{ .pNext = &m_descriptorBufferProperties };
+    m_gpu.getProperties2(&properties2);
+    m_descriptorBufferProperties.pNext = nullptr;
+  }
+
+  if (!m_descriptorBuffers && available.contains(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME)) {
+    vk::PhysicalDevicePushDescriptorPropertiesKHR pushDescriptorProperties{};
+    vk::PhysicalDeviceProperties2 properties2{ .pNext = &pushDescriptorProperties };
+    m_gpu.getProperties2(&properties2);
+
+    m_maxPushDescriptors = pushDescriptorProperties.maxPushDescriptors;
+    extensions.emplace_back(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME);
+  }
+
   vk::DeviceCreateInfo deviceCreateInfo{
     .pNext                    = &dynamicRenderingFeature,
     .queueCreateInfoCount     = static_cast<unsigned int>(queueCreateInfos.size()),
@@ -245,6 +481,18 @@ void VulkanContext::createDevice(std::vector<const char *>& extensions) {
   if (!m_device)
     Log::runtime_error("failed to create device");
 
+  if (m_dynamicBlend)
+    m_cmdSetColorBlendEnable = reinterpret_cast<PFN_vkCmdSetColorBlendEnableEXT>(m_device.getProcAddr("vkCmdSetColorBlendEnableEXT"));
+  if (m_maxPushDescriptors > 0)
+    m_cmdPushDescriptorSet = reinterpret_cast<PFN_vkCmdPushDescriptorSetKHR>(m_device.getProcAddr("vkCmdPushDescriptorSetKHR"));
+  if (m_descriptorBuffers) {
+    m_getDescriptorSetLayoutSize = reinterpret_cast<PFN_vkGetDescriptorSetLayoutSizeEXT>(m_device.getProcAddr("vkGetDescriptorSetLayoutSizeEXT"));
+    m_getDescriptorSetLayoutBindingOffset = reinterpret_cast<PFN_vkGetDescriptorSetLayoutBindingOffsetEXT>(m_device.getProcAddr("vkGetDescriptorSetLayoutBindingOffsetEXT"));
+    m_getDescriptor = reinterpret_cast<PFN_vkGetDescriptorEXT>(m_device.getProcAddr("vkGetDescriptorEXT"));
+    m_cmdBindDescriptorBuffers = reinterpret_cast<PFN_vkCmdBindDescriptorBuffersEXT>(m_device.getProcAddr("vkCmdBindDescriptorBuffersEXT"));
+    m_cmdSetDescriptorBufferOffsets = reinterpret_cast<PFN_vkCmdSetDescriptorBufferOffsetsEXT>(m_device.getProcAddr("vkCmdSetDescriptorBufferOffsetsEXT"));
+  }
+
   m_graphicsQueue = m_device.getQueue((m_queueFamilyIndices >> GRAPHICS_SHIFT) & 0xFF, 0);
   m_presentQueue = m_device.getQueue((m_queueFamilyIndices >> PRESENT_SHIFT) & 0xFF, 0);
   m_computeQueue = m_device.getQueue((m_queueFamilyIndices >> COMPUTE_SHIFT) & 0xFF, 0);
@@ -268,6 +516,19 @@ void VulkanContext::createCommandPools() {
   });
 }
 
+void VulkanContext::createPipelineCache(const std::string& path) {
+  m_pipelineCachePath = path;
+
+  std::vector<unsigned char> data = loadPipelineCacheData();
+  m_pipelineCache = m_device.createPipelineCache(vk::PipelineCacheCreateInfo{
+    .initialDataSize  = data.size(),
+    .pInitialData     = data.data()
+  });
+
+  if (!data.empty())
+    Log::generic(std::format("loaded pipeline cache {}", m_pipelineCachePath));
+}
+
 unsigned int VulkanContext::getQueueFamilyIndices() const {
   unsigned int queueFamilyIndex = 0, queueFamilyIndices = 0xFFFFFFFF;
   for (const auto& queueFamily : m_gpu.getQueueFamilyProperties()) {
@@ -324,4 +585,43 @@ std::vector<vk::DeviceQueueCreateInfo> VulkanContext::getQueueCreateInfos(const
   return queueCreateInfos;
 }
 
-} // namespace groot
\ No newline at end of file
+std::vector<unsigned char> VulkanContext::loadPipelineCacheData() const {
+  if (m_pipelineCachePath.empty()) return {};
+
+  std::ifstream file(m_pipelineCachePath, std::ios::binary | std::ios::ate);
+  if (!file) return {};
+
+  std::vector<unsigned char> data(file.tellg());
+  file.seekg(0);
+  if (!file.read(reinterpret_cast<char *>(data.data()), data.size())) return {};
+
+  struct {
+    unsigned int headerSize;
+    unsigned int headerVersion;
+    unsigned int vendorID;
+    unsigned int deviceID;
+    unsigned char uuid[VK_UUID_SIZE];
+  } header;
+
+  if (data.size() < sizeof(header)) {
+    Log::warn(std::format("pipeline cache {} is truncated and will be rebuilt", m_pipelineCachePath));
+    return {};
+  }
+  std::memcpy(&header, data.data(), sizeof(header));
+
+  vk::PhysicalDeviceProperties properties = m_gpu.getProperties();
+  bool valid = header.headerSize >= sizeof(header) &&
+    header.headerVersion == static_cast<unsigned int>(vk::PipelineCacheHeaderVersion::eOne) &&
+    header.vendorID == properties.vendorID &&
+    header.deviceID == properties.deviceID &&
+    std::memcmp(header.uuid, properties.pipelineCacheUUID.data(), VK_UUID_SIZE) == 0;
+
+  if (!valid) {
+    Log::warn(std::format("pipeline cache {} was created by a different GPU or driver and will be rebuilt", m_pipelineCachePath));
+    return {};
+  }
+
+  return data;
+}
+
+} // namespace groot
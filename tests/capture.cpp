@@ -0,0 +1,114 @@
+#include "src/include/frame_capture.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <iostream>
+#include <string>
+
+using namespace groot;
+
+namespace {
+
+unsigned int readU32(const std::vector<unsigned char>& data, std::size_t offset) {
+  return data[offset] << 24 | data[offset + 1] << 16 | data[offset + 2] << 8 | data[offset + 3];
+}
+
+unsigned int crc32(const unsigned char * data, std::size_t size) {
+  unsigned int crc = 0xFFFFFFFF;
+  for (std::size_t i = 0; i < size; ++i) {
+    crc ^= data[i];
+    for (unsigned int k = 0; k < 8; ++k)
+      crc = crc & 1 ? 0xEDB88320 ^ (crc >> 1) : crc >> 1;
+  }
+  return crc ^ 0xFFFFFFFF;
+}
+
+} // namespace
+
+TEST_CASE( "png encoding" ) {
+  std::println(std::cout, "--- png encoding ---");
+
+  std::vector<unsigned char> pixels = { 255, 0, 0, 255, 0, 255, 0, 128, 0, 0, 255, 255, 10, 20, 30, 40 };
+  std::vector<unsigned char> png = encodePNG(2, 2, pixels);
+
+  REQUIRE( png.size() > 8 );
+  CHECK( std::vector<unsigned char>(png.begin(), png.begin() + 8) == std::vector<unsigned char>{ 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' } );
+
+  std::vector<std::string> types;
+  std::vector<unsigned char> idat;
+  std::size_t offset = 8;
+  while (offset + 12 <= png.size()) {
+    unsigned int length = readU32(png, offset);
+    REQUIRE( offset + 12 + length <= png.size() );
+
+    std::string type(png.begin() + offset + 4, png.begin() + offset + 8);
+    types.emplace_back(type);
+    CHECK( readU32(png, offset + 8 + length) == crc32(png.data() + offset + 4, length + 4) );
+
+    if (type == "IHDR") {
+      CHECK( length == 13 );
+      CHECK( readU32(png, offset + 8) == 2 );
+      CHECK( readU32(png, offset + 12) == 2 );
+      CHECK( png[offset + 16] == 8 );
+      CHECK( png[offset + 17] == 6 );
+    }
+    else if (type == "IDAT")
+      idat.insert(idat.end(), png.begin() + offset + 8, png.begin() + offset + 8 + length);
+
+    offset += 12 + length;
+  }
+
+  CHECK( offset == png.size() );
+  CHECK( types == std::vector<std::string>{ "IHDR", "IDAT", "IEND" } );
+
+  std::vector<unsigned char> scanlines = { 0 };
+  scanlines.insert(scanlines.end(), pixels.begin(), pixels.begin() + 8);
+  scanlines.push_back(0);
+  scanlines.insert(scanlines.end(), pixels.begin() + 8, pixels.end());
+
+  REQUIRE( idat.size() == 2 + 5 + scanlines.size() + 4 );
+  CHECK( idat[0] == 0x78 );
+  CHECK( (idat[0] << 8 | idat[1]) % 31 == 0 );
+  CHECK( idat[2] == 1 );
+  CHECK( (idat[3] | idat[4] << 8) == scanlines.size() );
+  CHECK( (idat[5] | idat[6] << 8) == (~scanlines.size() & 0xFFFF) );
+  CHECK( std::vector<unsigned char>(idat.begin() + 7, idat.end() - 4) == scanlines );
+
+  unsigned int a = 1, b = 0;
+  for (unsigned char byte : scanlines) {
+    a = (a + byte) % 65521;
+    b = (b + a) % 65521;
+  }
+  CHECK( readU32(idat, idat.size() - 4) == (b << 16 | a) );
+}
+
+TEST_CASE( "qoi encoding" ) {
+  std::println(std::cout, "--- qoi encoding ---");
+
+  std::vector<unsigned char> pixels = {
+    10, 20, 30, 255,
+    10, 20, 30, 255,
+    11, 20, 29, 255,
+    10, 20, 30, 255,
+    10, 20, 30, 100
+  };
+
+  std::vector<unsigned char> expected = {
+    'q', 'o', 'i', 'f', 0, 0, 0, 5, 0, 0, 0, 1, 4, 0,
+    0xFE, 10, 20, 30,
+    0xC0,
+    0x79,
+    0x09,
+    0xFF, 10, 20, 30, 100,
+    0, 0, 0, 0, 0, 0, 0, 1
+  };
+
+  CHECK( encodeQOI(5, 1, pixels) == expected );
+
+  std::vector<unsigned char> flat = encodeQOI(8, 8, std::vector<unsigned char>(8 * 8 * 4, 0));
+  REQUIRE( flat.size() == 14 + 3 + 8 );
+  CHECK( flat[14] == 0x00 );
+  CHECK( flat[15] == (0xC0 | 61) );
+  CHECK( flat[16] == (0xC0 | 0) );
+  CHECK( std::vector<unsigned char>(flat.end() - 8, flat.end()) == std::vector<unsigned char>{ 0, 0, 0, 0, 0, 0, 0, 1 } );
+}
@@ -0,0 +1,16 @@
+#version 450
+#extension GL_EXT_nonuniform_qualifier : require
+
+layout(binding = 2) readonly buffer transforms {
+  mat4 _Model;
+} _Transforms[];
+
+layout(push_constant) uniform push_constants {
+  uint _Transform;
+};
+
+layout(location = 0) in vec3 _VertexPosition;
+
+void main() {
+  gl_Position = _Transforms[_Transform]._Model * vec4(_VertexPosition, 1.0);
+}
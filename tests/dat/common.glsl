@@ -0,0 +1 @@
+layout (location = 0) out vec4 color;
@@ -0,0 +1,11 @@
+#version 450
+
+layout(binding = 0) uniform transform {
+  mat4 _Model;
+};
+
+layout(location = 0) in vec3 _VertexPosition;
+
+void main() {
+  gl_Position = _Model * vec4(_VertexPosition, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,16 @@
+#version 450
+
+layout(set = 0, binding = 0) uniform frame {
+  mat4 _View;
+  mat4 _Proj;
+};
+
+layout(set = 1, binding = 0) uniform material {
+  mat4 _Model;
+};
+
+layout(location = 0) in vec3 _VertexPosition;
+
+void main() {
+  gl_Position = _Proj * _View * _Model * vec4(_VertexPosition, 1.0);
+}
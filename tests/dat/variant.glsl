@@ -0,0 +1,11 @@
+#version 450
+
+#include "common.glsl"
+
+void main() {
+#ifdef RED
+  color = vec4(1.0, 0.0, 0.0, 1.0);
+#else
+  color = vec4(SHADE, SHADE, SHADE, 1.0);
+#endif
+}
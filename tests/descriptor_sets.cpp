@@ -2,6 +2,7 @@
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <algorithm>
 #include <iostream>
 
 using namespace groot;
@@ -117,6 +118,147 @@ TEST_CASE( "descriptor set destruction" ) {
   CHECK_FALSE( set.is_valid() );
 }
 
+TEST_CASE( "descriptor set pools" ) {
+  std::println(std::cout, "--- descriptor set pools ---");
+
+  Engine engine;
+
+  RID buffer = engine.create_uniform_buffer(1024);
+  REQUIRE( buffer.is_valid() );
+
+  std::vector<RID> sets;
+  for (unsigned int i = 0; i < 100; ++i)
+    sets.emplace_back(engine.create_descriptor_set({ buffer }));
+
+  CHECK( std::all_of(sets.begin(), sets.end(), [](const RID& set) { return set.is_valid(); }) );
+
+  unsigned int pools = engine.descriptor_pools();
+  CHECK( pools <= 3 );
+
+  for (auto& set : sets)
+    engine.destroy_descriptor_set(set);
+
+  unsigned int frames = 0;
+  engine.run([&engine, &frames](double){
+    if (++frames == engine.flight_frames() + 1) engine.close_window();
+  });
+
+  for (unsigned int i = 0; i < 100; ++i)
+    sets[i] = engine.create_descriptor_set({ buffer });
+
+  CHECK( engine.descriptor_pools() == pools );
+}
+
+TEST_CASE( "descriptor set updates" ) {
+  std::println(std::cout, "--- descriptor set updates ---");
+
+  Engine engine;
+
+  RID first = engine.create_storage_buffer(256 * sizeof(int));
+  RID second = engine.create_storage_buffer(256 * sizeof(int));
+  RID set = engine.create_descriptor_set({ second });
+  REQUIRE( set.is_valid() );
+
+  RID shader = engine.compile_shader(ShaderType::Compute, std::format("{}/dat/compute.glsl", GROOT_TEST_DIR));
+  RID pipeline = engine.create_compute_pipeline(shader, set);
+  REQUIRE( pipeline.is_valid() );
+
+  engine.update_descriptor_set(set, 1, first);
+  engine.update_descriptor_set(set, 0, engine.create_uniform_buffer(64));
+
+  ComputeCommand cmd{
+    .pipeline       = pipeline,
+    .descriptor_set = set,
+    .push_constants = { 5, 0, 0, 0 },
+    .work_groups    = { 32, 1, 1 }
+  };
+
+  unsigned int frames = 0;
+  engine.run([&](double){
+    if (frames == 0)
+      engine.update_descriptor_set(set, 0, second);
+
+    if (frames == 1) {
+      engine.update_descriptor_set(set, 0, first);
+      cmd.push_constants = { 9, 0, 0, 0 };
+    }
+
+    engine.dispatch(cmd);
+    if (++frames == 2 * engine.flight_frames() + 2) engine.close_window();
+  });
+
+  CHECK( engine.read_buffer<int>(first) == std::vector<int>(256, 9) );
+}
+
+TEST_CASE( "descriptor buffers" ) {
+  std::println(std::cout, "--- descriptor buffers ---");
+
+  Engine engine(Settings{ .descriptor_buffers = true });
+  if (!engine.descriptor_buffers()) SKIP( "descriptor buffers are not supported" );
+
+  RID first = engine.create_storage_buffer(256 * sizeof(int));
+  RID second = engine.create_storage_buffer(256 * sizeof(int));
+  RID set = engine.create_descriptor_set({ first });
+  REQUIRE( set.is_valid() );
+
+  RID shader = engine.compile_shader(ShaderType::Compute, std::format("{}/dat/compute.glsl", GROOT_TEST_DIR));
+  RID pipeline = engine.create_compute_pipeline(shader, set);
+  REQUIRE( pipeline.is_valid() );
+
+  RID transient = engine.create_descriptor_set({ second });
+  engine.destroy_descriptor_set(transient);
+
+  RID source = engine.create_storage_texture(16, 16, engine.create_sampler({}), ImageType::two_dim, Format::rgba8_unorm);
+  RID destination = engine.create_storage_image(16, 16, ImageType::two_dim, Format::rgba8_unorm);
+  RID imageSet = engine.create_descriptor_set({ source, destination });
+  REQUIRE( imageSet.is_valid() );
+
+  std::vector<unsigned char> pixels(16 * 16 * 4);
+  for (unsigned int i = 0; i < pixels.size(); ++i)
+    pixels[i] = static_cast<unsigned char>(i);
+  engine.write_image(source, pixels);
+
+  RID copyShader = engine.compile_shader(ShaderType::Compute, std::format("{}/dat/copy_image.comp", GROOT_TEST_DIR));
+  RID copyPipeline = engine.create_compute_pipeline(copyShader, imageSet);
+  REQUIRE( copyPipeline.is_valid() );
+
+  RID postSet = engine.create_descriptor_set({ engine.render_target() });
+  RID postPipeline = engine.create_compute_pipeline(engine.compile_shader(ShaderType::Compute, std::format("{}/dat/post.comp", GROOT_TEST_DIR)), postSet);
+  REQUIRE( postPipeline.is_valid() );
+
+  ComputeCommand cmd{
+    .pipeline       = pipeline,
+    .descriptor_set = set,
+    .push_constants = { 4, 0, 0, 0 },
+    .work_groups    = { 32, 1, 1 }
+  };
+
+  auto [width, height] = engine.viewport_dims();
+
+  unsigned int frames = 0;
+  engine.run([&](double){
+    if (frames == 1) {
+      engine.update_descriptor_set(set, 0, second);
+      cmd.push_constants = { 6, 0, 0, 0 };
+    }
+
+    engine.dispatch(cmd);
+  },
+  [&](double){
+    engine.dispatch(ComputeCommand{ .pipeline = copyPipeline, .descriptor_set = imageSet, .work_groups = { 2, 2, 1 } });
+    engine.dispatch(ComputeCommand{
+      .pipeline       = postPipeline,
+      .descriptor_set = postSet,
+      .work_groups    = { (width + 7) / 8, (height + 7) / 8, 1 }
+    });
+    if (++frames == engine.flight_frames() + 2) engine.close_window();
+  });
+
+  CHECK( engine.read_buffer<int>(first) == std::vector<int>(256, 4) );
+  CHECK( engine.read_buffer<int>(second) == std::vector<int>(256, 6) );
+  CHECK( engine.read_image_async(destination).get() == pixels );
+}
+
 TEST_CASE( "invalid descriptor set operations" ) {
   Engine engine;
 
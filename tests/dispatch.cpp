@@ -2,6 +2,7 @@
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <cstring>
 #include <iostream>
 
 using namespace groot;
@@ -62,6 +63,39 @@ TEST_CASE( "compute dispatch" ) {
   CHECK( nums == result );
 }
 
+TEST_CASE( "specialized dispatch" ) {
+  std::println(std::cout, "--- specialized compute dispatch ---");
+
+  Engine engine;
+
+  RID buffer = engine.create_storage_buffer(256 * sizeof(int));
+  REQUIRE( buffer.is_valid() );
+
+  RID set = engine.create_descriptor_set({ buffer });
+  REQUIRE( set.is_valid() );
+
+  RID shader = engine.compile_shader(ShaderType::Compute, std::format("{}/dat/specialized.comp", GROOT_TEST_DIR));
+  REQUIRE( shader.is_valid() );
+
+  RID pipeline = engine.create_compute_pipeline(shader, set, SpecializationConstants().set(0, 64u).set(1, 7));
+  REQUIRE( pipeline.is_valid() );
+
+  RID mismatched = engine.create_compute_pipeline(shader, set, SpecializationConstants().set(1, 7.0));
+  CHECK_FALSE( mismatched.is_valid() );
+
+  engine.run([&engine, &pipeline, &set](double){
+    engine.dispatch(ComputeCommand{
+      .pipeline       = pipeline,
+      .descriptor_set = set,
+      .work_groups    = { 4, 1, 1 }
+    });
+    engine.close_window();
+  });
+
+  std::vector<int> nums = engine.read_buffer<int>(buffer);
+  CHECK( nums == std::vector<int>(256, 7) );
+}
+
 TEST_CASE( "invalid dispatch operations" ) {
   Engine engine;
 
@@ -154,4 +188,158 @@ TEST_CASE( "invalid dispatch operations" ) {
 
     CHECK( true );
   }
-}
\ No newline at end of file
+}
+
+TEST_CASE( "async pipelines" ) {
+  std::println(std::cout, "--- async pipeline creation ---");
+
+  Engine engine(Settings{ .worker_threads = 1 });
+
+  RID buffer = engine.create_storage_buffer(256 * sizeof(int));
+  RID set = engine.create_descriptor_set({ buffer });
+  RID shader = engine.compile_shader(ShaderType::Compute, std::format("{}/dat/specialized.comp", GROOT_TEST_DIR));
+  REQUIRE( shader.is_valid() );
+
+  RID fallback = engine.create_compute_pipeline(shader, set, SpecializationConstants().set(0, 8u).set(1, 3));
+  REQUIRE( fallback.is_valid() );
+
+  for (int i = 0; i < 64; ++i)
+    engine.create_compute_pipeline_async(shader, set, SpecializationConstants().set(0, 8u).set(1, 100 + i));
+
+  RID pipeline = engine.create_compute_pipeline_async(shader, set, SpecializationConstants().set(0, 8u).set(1, 5), fallback);
+  REQUIRE( pipeline.is_valid() );
+
+  ComputeCommand cmd{
+    .pipeline       = pipeline,
+    .descriptor_set = set,
+    .work_groups    = { 32, 1, 1 }
+  };
+
+  bool usedFallback = false, dispatchedPipeline = false;
+  std::vector<int> fallbackNums, nums;
+  unsigned int frame = 0, readFrame = 0;
+  engine.run([&](double){
+    if (++frame < readFrame) return;
+
+    if (readFrame == 0) {
+      usedFallback = engine.pipelines_pending() > 0;
+      engine.dispatch(cmd);
+      dispatchedPipeline = !usedFallback;
+      readFrame = frame + engine.flight_frames() + 1;
+    }
+    else if (!dispatchedPipeline) {
+      if (fallbackNums.empty()) fallbackNums = engine.read_buffer<int>(buffer);
+      if (engine.pipelines_pending() > 0) return;
+
+      engine.dispatch(cmd);
+      dispatchedPipeline = true;
+      readFrame = frame + engine.flight_frames() + 1;
+    }
+    else {
+      nums = engine.read_buffer<int>(buffer);
+      engine.close_window();
+    }
+  });
+
+  CHECK( engine.pipelines_pending() == 0 );
+  CHECK( nums == std::vector<int>(256, 5) );
+
+  RID shared = engine.create_compute_pipeline(shader, set, SpecializationConstants().set(0, 8u).set(1, 5));
+  CHECK( shared == pipeline );
+
+  engine.destroy_pipeline(shared);
+  engine.destroy_pipeline(pipeline);
+  CHECK_FALSE( pipeline.is_valid() );
+
+  if (!usedFallback) SKIP( "the pipeline finished before the first frame" );
+  CHECK( fallbackNums == std::vector<int>(256, 3) );
+}
+
+TEST_CASE( "bindless dispatch" ) {
+  std::println(std::cout, "--- bindless dispatch ---");
+
+  Engine engine(Settings{ .bindless_descriptors = true });
+
+  RID heap = engine.bindless_set();
+  if (!heap.is_valid()) SKIP( "bindless descriptors are not supported" );
+
+  RID first = engine.create_storage_buffer(64 * sizeof(int));
+  RID second = engine.create_storage_buffer(64 * sizeof(int));
+  unsigned int firstIndex = engine.bindless_index(first);
+  unsigned int secondIndex = engine.bindless_index(second);
+  REQUIRE( firstIndex != 0 );
+  REQUIRE( secondIndex != 0 );
+  CHECK( firstIndex != secondIndex );
+  CHECK( engine.bindless_index(engine.create_uniform_buffer(64)) == 0 );
+
+  RID shader = engine.compile_shader(ShaderType::Compute, std::format("{}/dat/bindless.comp", GROOT_TEST_DIR));
+  REQUIRE( shader.is_valid() );
+
+  RID pipeline = engine.create_compute_pipeline(shader, heap);
+  REQUIRE( pipeline.is_valid() );
+
+  auto command = [&pipeline, &heap](unsigned int index, int value) {
+    ComputeCommand cmd{ .pipeline = pipeline, .descriptor_set = heap, .work_groups = { 8, 1, 1 } };
+    cmd.push_constants.resize(2 * sizeof(int));
+    std::memcpy(cmd.push_constants.data(), &index, sizeof(int));
+    std::memcpy(cmd.push_constants.data() + sizeof(int), &value, sizeof(int));
+    return cmd;
+  };
+
+  engine.run([&](double){
+    engine.dispatch(command(firstIndex, 3));
+    engine.dispatch(command(secondIndex, 7));
+    engine.close_window();
+  });
+
+  CHECK( engine.read_buffer<int>(first) == std::vector<int>(64, 3) );
+  CHECK( engine.read_buffer<int>(second) == std::vector<int>(64, 7) );
+
+  engine.destroy_descriptor_set(heap);
+  CHECK( heap.is_valid() );
+}
+
+TEST_CASE( "push descriptor dispatch" ) {
+  std::println(std::cout, "--- push descriptor dispatch ---");
+
+  Engine engine;
+
+  RID shader = engine.compile_shader(ShaderType::Compute, std::format("{}/dat/compute.glsl", GROOT_TEST_DIR));
+  REQUIRE( shader.is_valid() );
+
+  RID pipeline = engine.create_push_compute_pipeline(shader);
+  if (!pipeline.is_valid()) SKIP( "push descriptors are not supported" );
+
+  CHECK( !engine.create_push_compute_pipeline(RID()).is_valid() );
+
+  RID first = engine.create_storage_buffer(256 * sizeof(int));
+  RID second = engine.create_storage_buffer(256 * sizeof(int));
+  RID uniform = engine.create_uniform_buffer(256 * sizeof(int));
+  unsigned int pools = engine.descriptor_pools();
+
+  engine.run([&](double){
+    engine.dispatch(ComputeCommand{
+      .pipeline         = pipeline,
+      .push_descriptors = { first },
+      .push_constants   = { 5, 0, 0, 0 },
+      .work_groups      = { 32, 1, 1 }
+    });
+    engine.dispatch(ComputeCommand{
+      .pipeline         = pipeline,
+      .push_descriptors = { second },
+      .push_constants   = { 9, 0, 0, 0 },
+      .work_groups      = { 32, 1, 1 }
+    });
+    engine.dispatch(ComputeCommand{ .pipeline = pipeline, .push_descriptors = { uniform }, .push_constants = { 1, 0, 0, 0 } });
+    engine.dispatch(ComputeCommand{ .pipeline = pipeline, .push_descriptors = { first, second }, .push_constants = { 2, 0, 0, 0 } });
+    engine.dispatch(ComputeCommand{ .pipeline = pipeline, .push_descriptors = { engine.render_target() } });
+    engine.close_window();
+  });
+
+  CHECK( engine.read_buffer<int>(first) == std::vector<int>(256, 5) );
+  CHECK( engine.read_buffer<int>(second) == std::vector<int>(256, 9) );
+  CHECK( engine.descriptor_pools() == pools );
+
+  engine.destroy_pipeline(pipeline);
+  CHECK( !pipeline.is_valid() );
+}
@@ -34,6 +34,76 @@ TEST_CASE( "image creation" ) {
 
     CHECK( storageTexture.is_valid() );
   }
+
+  SECTION( "texture array" ) {
+    std::println(std::cout, "--- create texture array ---");
+    RID sampler = engine.create_sampler({});
+    REQUIRE( sampler.is_valid() );
+
+    std::string path = std::format("{}/dat/test.png", GROOT_TEST_DIR);
+    RID textureArray = engine.create_texture_array({ path, path, path }, sampler);
+
+    CHECK( textureArray.is_valid() );
+  }
+
+  SECTION( "texture atlas" ) {
+    std::println(std::cout, "--- create texture atlas ---");
+    RID sampler = engine.create_sampler({});
+    REQUIRE( sampler.is_valid() );
+
+    std::string path = std::format("{}/dat/test.png", GROOT_TEST_DIR);
+    RID atlas = engine.create_texture_atlas({ path, path }, sampler);
+    REQUIRE( atlas.is_valid() );
+
+    std::vector<vec4> regions = engine.atlas_regions(atlas);
+    REQUIRE( regions.size() == 2 );
+    CHECK( regions[0] != regions[1] );
+    for (const auto& region : regions) {
+      CHECK( region.x + region.z <= 1.0f );
+      CHECK( region.y + region.w <= 1.0f );
+    }
+  }
+
+  SECTION( "layered storage images" ) {
+    std::println(std::cout, "--- create layered storage images ---");
+
+    RID volume = engine.create_storage_image(64, 64, 64);
+    CHECK( volume.is_valid() );
+
+    RID array = engine.create_storage_image(256, 256, 4, ImageType::two_dim_array);
+    CHECK( array.is_valid() );
+
+    RID cube = engine.create_storage_image(256, 256, ImageType::cube);
+    CHECK( cube.is_valid() );
+
+    RID cubeArray = engine.create_storage_image(256, 256, 12, ImageType::cube_array);
+    CHECK( cubeArray.is_valid() );
+
+    RID sampler = engine.create_sampler({});
+    REQUIRE( sampler.is_valid() );
+
+    RID volumeTexture = engine.create_storage_texture(64, 64, 64, sampler);
+    CHECK( volumeTexture.is_valid() );
+  }
+
+  SECTION( "write image" ) {
+    std::println(std::cout, "--- write image layers ---");
+
+    RID array = engine.create_storage_image(16, 16, 4, ImageType::two_dim_array);
+    REQUIRE( array.is_valid() );
+
+    std::vector<unsigned short> layer(16 * 16 * 4, 0xFFFF);
+    engine.write_image(array, layer, 2);
+
+    std::vector<unsigned short> layers(16 * 16 * 4 * 4, 0);
+    engine.write_image(array, layers);
+
+    RID volume = engine.create_storage_image(16, 16, 16);
+    REQUIRE( volume.is_valid() );
+
+    engine.write_image(volume, layer, 15);
+    CHECK( true );
+  }
 }
 
 TEST_CASE( "image destruction" ) {
@@ -66,6 +136,45 @@ TEST_CASE( "image destruction" ) {
   }
 }
 
+TEST_CASE( "image readback" ) {
+  Engine engine;
+
+  SECTION( "read full image" ) {
+    std::println(std::cout, "--- read full image ---");
+
+    RID image = engine.create_storage_image(16, 16, ImageType::two_dim, Format::rgba8_unorm);
+    REQUIRE( image.is_valid() );
+
+    std::vector<unsigned char> pixels(16 * 16 * 4);
+    for (unsigned int i = 0; i < pixels.size(); ++i)
+      pixels[i] = static_cast<unsigned char>(i);
+    engine.write_image(image, pixels);
+
+    std::future<std::vector<unsigned char>> readback = engine.read_image_async(image);
+    REQUIRE( readback.valid() );
+    CHECK( readback.get() == pixels );
+  }
+
+  SECTION( "read image region" ) {
+    std::println(std::cout, "--- read image region ---");
+
+    RID array = engine.create_storage_image(8, 8, 2, ImageType::two_dim_array, Format::rgba8_unorm);
+    REQUIRE( array.is_valid() );
+
+    engine.write_image(array, std::vector<unsigned char>(8 * 8 * 4, 7), 1);
+
+    std::future<std::vector<unsigned char>> readback = engine.read_image_async(array, ImageRegion{
+      .x      = 2,
+      .y      = 2,
+      .width  = 4,
+      .height = 4,
+      .layer  = 1
+    });
+    REQUIRE( readback.valid() );
+    CHECK( readback.get() == std::vector<unsigned char>(4 * 4 * 4, 7) );
+  }
+}
+
 TEST_CASE( "invalid image operations" ) {
   Engine engine;
 
@@ -132,6 +241,26 @@ TEST_CASE( "invalid image operations" ) {
     CHECK_FALSE( texture.is_valid() );
   }
 
+  SECTION( "create texture array with no images" ) {
+    std::println(std::cout, "--- create texture array with no images ---");
+
+    RID sampler = engine.create_sampler({});
+    REQUIRE( sampler.is_valid() );
+
+    RID textureArray = engine.create_texture_array({}, sampler);
+    CHECK_FALSE( textureArray.is_valid() );
+  }
+
+  SECTION( "create texture atlas with invalid image" ) {
+    std::println(std::cout, "--- create texture atlas with invalid image ---");
+
+    RID sampler = engine.create_sampler({});
+    REQUIRE( sampler.is_valid() );
+
+    RID atlas = engine.create_texture_atlas({ std::format("{}/dat/test.png", GROOT_TEST_DIR), "" }, sampler);
+    CHECK_FALSE( atlas.is_valid() );
+  }
+
   SECTION( "create storage texture with invalid sampler RID" ) {
     std::println(std::cout, "--- create storage texture with invalid sampler RID ---");
 
@@ -160,4 +289,56 @@ TEST_CASE( "invalid image operations" ) {
     RID storageTexture = engine.create_storage_texture(1024, 1024, sampler, ImageType::two_dim, Format::undefined);
     CHECK_FALSE( storageTexture.is_valid() );
   }
-}
\ No newline at end of file
+
+  SECTION( "invalid layered images" ) {
+    std::println(std::cout, "--- create invalid layered images ---");
+
+    RID image = engine.create_storage_image(256, 128, ImageType::cube);
+    CHECK_FALSE( image.is_valid() );
+
+    image = engine.create_storage_image(256, 256, 4, ImageType::cube);
+    CHECK_FALSE( image.is_valid() );
+
+    image = engine.create_storage_image(256, 256, 8, ImageType::cube_array);
+    CHECK_FALSE( image.is_valid() );
+
+    image = engine.create_storage_image(256, 256, 0, ImageType::two_dim_array);
+    CHECK_FALSE( image.is_valid() );
+
+    image = engine.create_storage_image(256, 256, 2, ImageType::two_dim);
+    CHECK_FALSE( image.is_valid() );
+  }
+
+  SECTION( "write partial or out of range image layers" ) {
+    std::println(std::cout, "--- write invalid image layers ---");
+
+    RID array = engine.create_storage_image(16, 16, 2, ImageType::two_dim_array);
+    REQUIRE( array.is_valid() );
+
+    engine.write_image(array, std::vector<unsigned short>(10, 0));
+    engine.write_image(array, std::vector<unsigned short>(16 * 16 * 4, 0), 2);
+
+    RID buffer = engine.create_uniform_buffer(1024);
+    REQUIRE( buffer.is_valid() );
+
+    engine.write_image(buffer, std::vector<unsigned short>(16 * 16 * 4, 0));
+    CHECK( true );
+  }
+
+  SECTION( "invalid readbacks" ) {
+    std::println(std::cout, "--- invalid image readbacks ---");
+
+    RID image = engine.create_storage_image(16, 16);
+    REQUIRE( image.is_valid() );
+
+    CHECK_FALSE( engine.read_image_async(RID()).valid() );
+    CHECK_FALSE( engine.read_image_async(image, ImageRegion{ .x = 8, .width = 16 }).valid() );
+    CHECK_FALSE( engine.read_image_async(image, ImageRegion{ .layer = 1 }).valid() );
+    CHECK_FALSE( engine.read_image_async(engine.render_target()).valid() );
+
+    RID buffer = engine.create_uniform_buffer(1024);
+    REQUIRE( buffer.is_valid() );
+
+    CHECK_FALSE( engine.read_image_async(buffer).valid() );
+  }
+}
@@ -2,10 +2,47 @@
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <iterator>
 
 using namespace groot;
 
+namespace {
+
+enum class Shade { Clear, Red, Grey };
+
+mat4 sampleQuad(unsigned int sample, float depth = 0.0f) {
+  return mat4::translation(vec3(-0.875f + 0.25f * sample, 0.0f, depth)) * mat4::scale(0.125f, 0.125f, 1.0f);
+}
+
+std::vector<Shade> sampleDrawOutput(Engine& engine) {
+  RID samples = engine.create_storage_buffer(8 * 4 * sizeof(float));
+  RID set = engine.create_descriptor_set({ engine.render_target(), samples });
+  RID pipeline = engine.create_compute_pipeline(engine.compile_shader(ShaderType::Compute, std::format("{}/dat/readback.comp", GROOT_TEST_DIR)), set);
+  if (!pipeline.is_valid()) return {};
+
+  unsigned int frames = 0;
+  engine.run([](double){}, [&](double){
+    engine.dispatch(ComputeCommand{ .pipeline = pipeline, .descriptor_set = set });
+    if (++frames == engine.flight_frames() + 1) engine.close_window();
+  });
+
+  std::vector<float> pixels = engine.read_buffer<float>(samples);
+  std::vector<Shade> shades;
+  for (unsigned int i = 0; i + 3 < pixels.size(); i += 4) {
+    if (pixels[i] > 0.9f && pixels[i + 1] < 0.1f) shades.push_back(Shade::Red);
+    else if (pixels[i + 1] > 0.1f) shades.push_back(Shade::Grey);
+    else shades.push_back(Shade::Clear);
+  }
+
+  return shades;
+}
+
+} // namespace
+
 TEST_CASE( "pipeline creation" ) {
   Engine engine;
 
@@ -149,6 +186,48 @@ TEST_CASE( "invalid pipeline operations" ) {
     CHECK_FALSE( graphicsPipeline.is_valid() );
   }
 
+  SECTION( "mismatched descriptor set" ) {
+    std::println(std::cout, "--- create pipeline with mismatched descriptor set ---");
+
+    RID storageCompute = engine.compile_shader(ShaderType::Compute, std::format("{}/dat/compute.glsl", GROOT_TEST_DIR));
+    REQUIRE( storageCompute.is_valid() );
+
+    RID computePipeline = engine.create_compute_pipeline(storageCompute, set);
+    CHECK_FALSE( computePipeline.is_valid() );
+
+    RID emptySet = engine.create_descriptor_set({});
+    REQUIRE( emptySet.is_valid() );
+
+    computePipeline = engine.create_compute_pipeline(storageCompute, emptySet);
+    CHECK_FALSE( computePipeline.is_valid() );
+  }
+
+  SECTION( "render target descriptor set" ) {
+    std::println(std::cout, "--- create graphics pipeline with render target descriptor set ---");
+
+    RID targetSet = engine.create_descriptor_set({ engine.render_target() });
+    REQUIRE( targetSet.is_valid() );
+
+    RID graphicsPipeline = engine.create_graphics_pipeline(GraphicsPipelineShaders{
+      .vertex = vertex,
+      .fragment = fragment
+    }, targetSet, GraphicsPipelineSettings{});
+    CHECK_FALSE( graphicsPipeline.is_valid() );
+
+    RID pipeline = engine.create_graphics_pipeline(GraphicsPipelineShaders{
+      .vertex = vertex,
+      .fragment = fragment
+    }, set, GraphicsPipelineSettings{});
+    REQUIRE( pipeline.is_valid() );
+
+    Object object;
+    object.set_mesh(engine.load_mesh(std::format("{}/dat/cube.obj", GROOT_TEST_DIR)));
+    object.set_pipeline(pipeline);
+    object.set_descriptor_set(targetSet);
+    engine.add_to_scene(object);
+    CHECK_FALSE( object.is_in_scene() );
+  }
+
   SECTION( "destroy invalid RID" ) {
     std::println(std::cout, "--- destroy invalid pipeline RID ---");
 
@@ -163,4 +242,377 @@ TEST_CASE( "invalid pipeline operations" ) {
     engine.destroy_pipeline(buffer);
     CHECK( buffer.is_valid() );
   }
-}
\ No newline at end of file
+}
+
+TEST_CASE( "pipeline cache" ) {
+  std::println(std::cout, "--- persistent pipeline cache ---");
+
+  std::filesystem::path cache = std::filesystem::temp_directory_path() / "groot_pipeline_cache_test" / "pipelines.cache";
+  std::filesystem::remove_all(cache.parent_path());
+
+  for (unsigned int run = 0; run < 2; ++run) {
+    Engine engine(Settings{ .pipeline_cache_path = cache.string() });
+
+    RID buffer = engine.create_storage_buffer(1024);
+    RID set = engine.create_descriptor_set({ buffer });
+    RID shader = engine.compile_shader(ShaderType::Compute, std::format("{}/dat/compute.glsl", GROOT_TEST_DIR));
+    RID pipeline = engine.create_compute_pipeline(shader, set);
+    CHECK( pipeline.is_valid() );
+  }
+
+  REQUIRE( std::filesystem::exists(cache) );
+
+  auto readCache = [&cache] {
+    std::ifstream file(cache, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  };
+  auto writeCache = [&cache](const std::vector<char>& data) {
+    std::ofstream file(cache, std::ios::binary | std::ios::trunc);
+    file.write(data.data(), data.size());
+  };
+
+  std::vector<char> original = readCache();
+  REQUIRE( original.size() >= 32 );
+
+  for (std::size_t offset : { 8, 16 }) {
+    std::vector<char> mismatched = original;
+    mismatched[offset] = static_cast<char>(~mismatched[offset]);
+    writeCache(mismatched);
+
+    {
+      Engine engine(Settings{ .pipeline_cache_path = cache.string() });
+      RID shader = engine.compile_shader(ShaderType::Compute, std::format("{}/dat/shader.glsl", GROOT_TEST_DIR));
+      RID set = engine.create_descriptor_set({});
+      CHECK( engine.create_compute_pipeline(shader, set).is_valid() );
+    }
+
+    std::vector<char> rebuilt = readCache();
+    REQUIRE( rebuilt.size() >= 32 );
+    CHECK( std::equal(original.begin(), original.begin() + 32, rebuilt.begin()) );
+  }
+
+  writeCache({ 'n', 'o', 't', ' ', 'a', ' ', 'c', 'a', 'c', 'h', 'e' });
+
+  {
+    Engine engine(Settings{ .pipeline_cache_path = cache.string() });
+    RID shader = engine.compile_shader(ShaderType::Compute, std::format("{}/dat/shader.glsl", GROOT_TEST_DIR));
+    RID set = engine.create_descriptor_set({});
+    CHECK( engine.create_compute_pipeline(shader, set).is_valid() );
+  }
+
+  std::filesystem::remove_all(cache.parent_path());
+}
+
+TEST_CASE( "pipeline deduplication" ) {
+  std::println(std::cout, "--- deduplicate pipelines ---");
+
+  Engine engine;
+
+  std::string shaderPath = std::format("{}/dat/shader.glsl", GROOT_TEST_DIR);
+  RID vertex = engine.compile_shader(ShaderType::Vertex, shaderPath);
+  RID fragment = engine.compile_shader(ShaderType::Fragment, shaderPath);
+  RID compute = engine.compile_shader(ShaderType::Compute, shaderPath);
+  RID first = engine.create_descriptor_set({ engine.create_uniform_buffer(64) });
+  RID second = engine.create_descriptor_set({ engine.create_uniform_buffer(64) });
+
+  RID computeA = engine.create_compute_pipeline(compute, first);
+  RID computeB = engine.create_compute_pipeline(compute, second);
+  REQUIRE( computeA.is_valid() );
+  CHECK( computeA == computeB );
+
+  GraphicsPipelineShaders shaders{ .vertex = vertex, .fragment = fragment };
+  RID graphicsA = engine.create_graphics_pipeline(shaders, first, {});
+  RID graphicsB = engine.create_graphics_pipeline(shaders, second, {});
+  RID graphicsC = engine.create_graphics_pipeline(shaders, first, { .cull_mode = CullMode::None });
+  REQUIRE( graphicsA.is_valid() );
+  CHECK( graphicsA == graphicsB );
+  CHECK( graphicsA != graphicsC );
+
+  engine.destroy_descriptor_set(first);
+  engine.destroy_descriptor_set(second);
+  RID third = engine.create_descriptor_set({ engine.create_uniform_buffer(64) });
+  CHECK( engine.create_compute_pipeline(compute, third) == computeA );
+
+  engine.destroy_pipeline(computeA);
+  CHECK_FALSE( computeA.is_valid() );
+  CHECK( computeB.is_valid() );
+
+  engine.destroy_pipeline(computeB);
+  CHECK_FALSE( computeB.is_valid() );
+}
+
+TEST_CASE( "dynamic pipeline state" ) {
+  std::println(std::cout, "--- dynamic pipeline state ---");
+
+  Engine engine(Settings{ .dynamic_pipeline_state = true });
+
+  std::string shaderPath = std::format("{}/dat/shader.glsl", GROOT_TEST_DIR);
+  RID vertex = engine.compile_shader(ShaderType::Vertex, shaderPath);
+  RID fragment = engine.compile_shader(ShaderType::Fragment, shaderPath);
+  RID set = engine.create_descriptor_set({ engine.create_uniform_buffer(64) });
+
+  GraphicsPipelineShaders shaders{ .vertex = vertex, .fragment = fragment };
+  RID back = engine.create_graphics_pipeline(shaders, set, { .cull_mode = CullMode::Back });
+  RID front = engine.create_graphics_pipeline(shaders, set, {
+    .cull_mode          = CullMode::Front,
+    .draw_direction     = DrawDirection::Clockwise,
+    .enable_depth_write = false,
+    .depth_compare      = CompareOp::LessOrEqual
+  });
+  RID wireframe = engine.create_graphics_pipeline(shaders, set, { .mesh_type = MeshType::Wireframe });
+
+  REQUIRE( back.is_valid() );
+  REQUIRE( front.is_valid() );
+  CHECK( back != wireframe );
+
+  if (!engine.dynamic_pipeline_state()) SKIP( "extended dynamic state is not supported" );
+  CHECK( back == front );
+
+  RID flat = engine.compile_shader(ShaderType::Vertex, std::format("{}/dat/flat_vert.glsl", GROOT_TEST_DIR));
+  std::string variantPath = std::format("{}/dat/variant.glsl", GROOT_TEST_DIR);
+  RID redShader = engine.compile_shader(ShaderType::Fragment, variantPath, { { "RED" } });
+  RID greyShader = engine.compile_shader(ShaderType::Fragment, variantPath, { { "SHADE", "0.5" } });
+  REQUIRE( flat.is_valid() );
+  REQUIRE( redShader.is_valid() );
+  REQUIRE( greyShader.is_valid() );
+
+  RID red = engine.create_graphics_pipeline(GraphicsPipelineShaders{ .vertex = flat, .fragment = redShader }, set, { .cull_mode = CullMode::None });
+  RID grey = engine.create_graphics_pipeline(GraphicsPipelineShaders{ .vertex = flat, .fragment = greyShader }, set, { .cull_mode = CullMode::None });
+  REQUIRE( red.is_valid() );
+  REQUIRE( grey.is_valid() );
+
+  RID plane = engine.load_mesh(std::format("{}/dat/plane.obj", GROOT_TEST_DIR));
+
+  std::vector<Object> objects;
+  objects.reserve(12);
+  auto quad = [&](RID pipeline, unsigned int sample, float depth) -> Object& {
+    RID transform = engine.create_uniform_buffer(sizeof(mat4));
+    engine.write_buffer(transform, sampleQuad(sample, depth));
+
+    Object& object = objects.emplace_back();
+    object.set_mesh(plane);
+    object.set_pipeline(pipeline);
+    object.set_descriptor_set(engine.create_descriptor_set({ transform }));
+    return object;
+  };
+
+  quad(red, 0, 0.5f);
+  quad(red, 1, 0.5f).set_cull_mode(CullMode::Front);
+  quad(red, 2, 0.5f).set_cull_mode(CullMode::Back);
+  Object& clockwise = quad(red, 7, 0.5f);
+  clockwise.set_cull_mode(CullMode::Back);
+  clockwise.set_draw_direction(DrawDirection::Clockwise);
+
+  quad(red, 3, 0.25f);
+  quad(red, 4, 0.25f).set_depth_write(false);
+  quad(red, 5, 0.25f);
+  quad(red, 6, 0.25f);
+  quad(grey, 3, 0.5f);
+  quad(grey, 4, 0.5f);
+  quad(grey, 5, 0.5f).set_depth_test(false);
+  quad(grey, 6, 0.5f).set_depth_compare(CompareOp::Greater);
+
+  for (auto& object : objects) {
+    engine.add_to_scene(object);
+    REQUIRE( object.is_in_scene() );
+  }
+
+  std::vector<Shade> shades = sampleDrawOutput(engine);
+  REQUIRE( shades.size() == 8 );
+
+  CHECK( shades[0] == Shade::Red );
+  CHECK( shades[1] != shades[2] );
+  CHECK( (shades[1] == Shade::Red || shades[2] == Shade::Red) );
+  CHECK( shades[7] == shades[1] );
+  CHECK( shades[3] == Shade::Red );
+  CHECK( shades[4] == Shade::Grey );
+  CHECK( shades[5] == Shade::Grey );
+  CHECK( shades[6] == Shade::Grey );
+}
+
+TEST_CASE( "pipeline libraries" ) {
+  std::println(std::cout, "--- graphics pipeline libraries ---");
+
+  for (bool libraries : { true, false }) {
+    Engine engine(Settings{ .graphics_pipeline_libraries = libraries });
+
+    std::string shaderPath = std::format("{}/dat/shader.glsl", GROOT_TEST_DIR);
+    RID vertex = engine.compile_shader(ShaderType::Vertex, shaderPath);
+    RID fragment = engine.compile_shader(ShaderType::Fragment, shaderPath);
+    RID set = engine.create_descriptor_set({ engine.create_uniform_buffer(64) });
+
+    GraphicsPipelineShaders shaders{ .vertex = vertex, .fragment = fragment };
+    RID back = engine.create_graphics_pipeline(shaders, set, { .cull_mode = CullMode::Back });
+    RID front = engine.create_graphics_pipeline(shaders, set, { .cull_mode = CullMode::Front });
+    RID blended = engine.create_graphics_pipeline(shaders, set, { .cull_mode = CullMode::Front, .enable_blend = false });
+
+    CHECK( back.is_valid() );
+    CHECK( front.is_valid() );
+    CHECK( blended.is_valid() );
+
+    unsigned int frames = 0;
+    engine.run([&engine, &frames](double){
+      if (++frames == 3) engine.close_window();
+    });
+
+    engine.destroy_pipeline(front);
+    CHECK_FALSE( front.is_valid() );
+  }
+}
+
+TEST_CASE( "multiple descriptor sets" ) {
+  std::println(std::cout, "--- multiple descriptor sets ---");
+
+  Engine engine;
+
+  RID vertex = engine.compile_shader(ShaderType::Vertex, std::format("{}/dat/multiset_vert.glsl", GROOT_TEST_DIR));
+  RID fragment = engine.compile_shader(ShaderType::Fragment, std::format("{}/dat/variant.glsl", GROOT_TEST_DIR), { { "RED" } });
+  REQUIRE( vertex.is_valid() );
+  REQUIRE( fragment.is_valid() );
+
+  RID frameBuffer = engine.create_uniform_buffer(128);
+  RID firstBuffer = engine.create_uniform_buffer(64);
+  RID secondBuffer = engine.create_uniform_buffer(64);
+  RID frame = engine.create_descriptor_set({ frameBuffer });
+  RID first = engine.create_descriptor_set({ firstBuffer });
+  RID second = engine.create_descriptor_set({ secondBuffer });
+
+  GraphicsPipelineShaders shaders{ .vertex = vertex, .fragment = fragment };
+  RID missing = engine.create_graphics_pipeline(shaders, frame, {});
+  CHECK_FALSE( missing.is_valid() );
+
+  RID pipeline = engine.create_graphics_pipeline(shaders, { frame, first }, { .cull_mode = CullMode::None });
+  REQUIRE( pipeline.is_valid() );
+  CHECK( engine.create_graphics_pipeline(shaders, { frame, second }, { .cull_mode = CullMode::None }) == pipeline );
+
+  engine.write_buffer(frameBuffer, std::vector<mat4>{ mat4::identity(), mat4::identity() });
+  engine.write_buffer(firstBuffer, sampleQuad(0));
+  engine.write_buffer(secondBuffer, sampleQuad(7));
+
+  RID mesh = engine.load_mesh(std::format("{}/dat/plane.obj", GROOT_TEST_DIR));
+
+  Object a, b;
+  for (auto * object : { &a, &b }) {
+    object->set_mesh(mesh);
+    object->set_pipeline(pipeline);
+    object->set_descriptor_set(frame, 0);
+  }
+  a.set_descriptor_set(first, 1);
+  b.set_descriptor_set(second, 1);
+
+  engine.add_to_scene(a);
+  engine.add_to_scene(b);
+
+  std::vector<Shade> shades = sampleDrawOutput(engine);
+  REQUIRE( shades.size() == 8 );
+
+  CHECK( shades[0] == Shade::Red );
+  CHECK( shades[3] == Shade::Clear );
+  CHECK( shades[7] == Shade::Red );
+}
+
+TEST_CASE( "object push constants" ) {
+  std::println(std::cout, "--- object push constants ---");
+
+  Engine engine(Settings{ .bindless_descriptors = true });
+
+  RID heap = engine.bindless_set();
+  if (!heap.is_valid()) SKIP( "bindless descriptors are not supported" );
+
+  RID vertex = engine.compile_shader(ShaderType::Vertex, std::format("{}/dat/bindless_vert.glsl", GROOT_TEST_DIR));
+  RID fragment = engine.compile_shader(ShaderType::Fragment, std::format("{}/dat/variant.glsl", GROOT_TEST_DIR), { { "RED" } });
+  REQUIRE( vertex.is_valid() );
+  REQUIRE( fragment.is_valid() );
+
+  RID pipeline = engine.create_graphics_pipeline(GraphicsPipelineShaders{ .vertex = vertex, .fragment = fragment }, heap, { .cull_mode = CullMode::None });
+  REQUIRE( pipeline.is_valid() );
+
+  RID mesh = engine.load_mesh(std::format("{}/dat/plane.obj", GROOT_TEST_DIR));
+  RID left = engine.create_storage_buffer(sizeof(mat4));
+  RID right = engine.create_storage_buffer(sizeof(mat4));
+  engine.write_buffer(left, sampleQuad(1, 0.5f));
+  engine.write_buffer(right, sampleQuad(6, 0.5f));
+
+  Object a, b, oversized;
+  for (auto * object : { &a, &b, &oversized }) {
+    object->set_mesh(mesh);
+    object->set_pipeline(pipeline);
+    object->set_descriptor_set(heap);
+  }
+  a.set_push_constants(engine.bindless_index(left));
+  b.set_push_constants(engine.bindless_index(right));
+  oversized.set_push_constants(std::vector<unsigned char>(8));
+
+  engine.add_to_scene(a);
+  engine.add_to_scene(b);
+  engine.add_to_scene(oversized);
+  CHECK( a.is_in_scene() );
+  CHECK( b.is_in_scene() );
+  CHECK_FALSE( oversized.is_in_scene() );
+
+  std::vector<Shade> shades = sampleDrawOutput(engine);
+  REQUIRE( shades.size() == 8 );
+
+  CHECK( shades[1] == Shade::Red );
+  CHECK( shades[3] == Shade::Clear );
+  CHECK( shades[6] == Shade::Red );
+}
+
+TEST_CASE( "compact vertex layout" ) {
+  std::println(std::cout, "--- compact vertex layout ---");
+
+  STATIC_REQUIRE( StandardVertex::stride == 32 );
+  STATIC_REQUIRE( CompactVertex::stride == 16 );
+
+  Engine engine;
+
+  std::string shaderPath = std::format("{}/dat/shader.glsl", GROOT_TEST_DIR);
+  RID vertex = engine.compile_shader(ShaderType::Vertex, shaderPath);
+  RID fragment = engine.compile_shader(ShaderType::Fragment, shaderPath);
+  RID set = engine.create_descriptor_set({ engine.create_uniform_buffer(64) });
+
+  GraphicsPipelineShaders shaders{ .vertex = vertex, .fragment = fragment };
+  RID standard = engine.create_graphics_pipeline(shaders, set, {});
+  RID compact = engine.create_graphics_pipeline(shaders, set, { .vertex_format = CompactVertex::format() });
+  REQUIRE( compact.is_valid() );
+  CHECK( standard != compact );
+
+  RID mesh = engine.load_mesh<CompactVertex>(std::format("{}/dat/cube.obj", GROOT_TEST_DIR));
+  REQUIRE( mesh.is_valid() );
+  CHECK( engine.mesh_dequantization(mesh) == mat4::scale(0.5f, 0.5f, 0.5f) );
+  CHECK_FALSE( engine.load_mesh(std::format("{}/dat/cube.obj", GROOT_TEST_DIR), VertexFormat{}).is_valid() );
+
+  Object mismatched;
+  mismatched.set_mesh(mesh);
+  mismatched.set_pipeline(standard);
+  mismatched.set_descriptor_set(set);
+  engine.add_to_scene(mismatched);
+  CHECK_FALSE( mismatched.is_in_scene() );
+
+  RID flat = engine.compile_shader(ShaderType::Vertex, std::format("{}/dat/flat_vert.glsl", GROOT_TEST_DIR));
+  RID red = engine.compile_shader(ShaderType::Fragment, std::format("{}/dat/variant.glsl", GROOT_TEST_DIR), { { "RED" } });
+  RID transform = engine.create_uniform_buffer(sizeof(mat4));
+  RID transformSet = engine.create_descriptor_set({ transform });
+  RID drawn = engine.create_graphics_pipeline(GraphicsPipelineShaders{ .vertex = flat, .fragment = red }, transformSet, {
+    .cull_mode      = CullMode::None,
+    .vertex_format  = CompactVertex::format()
+  });
+  REQUIRE( drawn.is_valid() );
+
+  RID plane = engine.load_mesh<CompactVertex>(std::format("{}/dat/plane.obj", GROOT_TEST_DIR));
+  REQUIRE( plane.is_valid() );
+  engine.write_buffer(transform, sampleQuad(2) * engine.mesh_dequantization(plane));
+
+  Object object;
+  object.set_mesh(plane);
+  object.set_pipeline(drawn);
+  object.set_descriptor_set(transformSet);
+  engine.add_to_scene(object);
+  CHECK( object.is_in_scene() );
+
+  std::vector<Shade> shades = sampleDrawOutput(engine);
+  REQUIRE( shades.size() == 8 );
+
+  CHECK( shades[2] == Shade::Red );
+  CHECK( shades[5] == Shade::Clear );
+}
@@ -13,8 +13,9 @@ struct TransformBuffer {
 
 TEST_CASE( "render", "[render]" ) {
   Engine engine(Settings{
-    .application_name = "Render Test",
-    .window_title     = "Groot Engine Render Test",
+    .application_name       = "Render Test",
+    .window_title           = "Groot Engine Render Test",
+    .dynamic_pipeline_state = true
   });
 
   RID cube_vert = engine.compile_shader(ShaderType::Vertex, std::format("{}/dat/cube_vert.glsl", GROOT_TEST_DIR));
@@ -52,7 +53,7 @@ TEST_CASE( "render", "[render]" ) {
     .vertex   = cube_vert,
     .fragment = cube_frag
   }, cube_set, GraphicsPipelineSettings{
-    .cull_mode = CullMode::Front,
+    .cull_mode          = CullMode::Front,
     .enable_depth_write = false
   });
 
@@ -91,11 +92,22 @@ TEST_CASE( "render", "[render]" ) {
   cube_front.set_pipeline(cube_pipeline_front);
   cube_front.set_descriptor_set(cube_set);
 
+  if (engine.dynamic_pipeline_state()) {
+    cube_back.set_cull_mode(CullMode::Front);
+    cube_front.set_cull_mode(CullMode::Back);
+  }
+
   Object plane;
   plane.set_descriptor_set(plane_set);
   plane.set_mesh(plane_mesh);
   plane.set_pipeline(plane_pipeline);
 
+  RID post_set = engine.create_descriptor_set({ engine.render_target() });
+  REQUIRE( post_set.is_valid() );
+
+  RID post_pipeline = engine.create_compute_pipeline(post_comp, post_set);
+  REQUIRE( post_pipeline.is_valid() );
+
   engine.add_to_scene(cube_back);
   engine.add_to_scene(cube_front);
   engine.add_to_scene(plane);
@@ -190,10 +202,7 @@ TEST_CASE( "render", "[render]" ) {
     plane_transform_buffer.view = engine.camera_view();
     engine.write_buffer(plane_buffer, plane_transform_buffer);
   },
-  [&engine, &width, &height, &post_comp](double){
-    RID post_set = engine.create_descriptor_set({ engine.render_target() });
-    RID post_pipeline = engine.create_compute_pipeline(post_comp, post_set);
-
+  [&engine, &width, &height, &post_set, &post_pipeline](double){
     engine.dispatch(ComputeCommand{
       .pipeline       = post_pipeline,
       .descriptor_set = post_set,
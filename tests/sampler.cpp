@@ -15,6 +15,50 @@ TEST_CASE( "create sampler" ) {
   CHECK( sampler.is_valid() );
 }
 
+TEST_CASE( "sampler cache" ) {
+  Engine engine;
+
+  SECTION( "identical settings share a sampler" ) {
+    std::println(std::cout, "--- deduplicate samplers ---");
+
+    RID first = engine.create_sampler({});
+    RID second = engine.create_sampler({});
+    REQUIRE( first.is_valid() );
+    CHECK( first == second );
+
+    RID other = engine.create_sampler(SamplerSettings{ .mag_filter = Filter::Nearest });
+    CHECK_FALSE( other == first );
+  }
+
+  SECTION( "shared sampler survives until last reference" ) {
+    std::println(std::cout, "--- release shared sampler ---");
+
+    RID first = engine.create_sampler({});
+    RID second = engine.create_sampler({});
+    REQUIRE( first.is_valid() );
+
+    engine.destroy_sampler(first);
+    CHECK_FALSE( first.is_valid() );
+
+    RID texture = engine.create_texture(std::format("{}/dat/test.png", GROOT_TEST_DIR), second);
+    CHECK( texture.is_valid() );
+  }
+
+  SECTION( "compare, border, and lod bias settings" ) {
+    std::println(std::cout, "--- create comparison sampler ---");
+
+    RID sampler = engine.create_sampler(SamplerSettings{
+      .mode_u         = SampleMode::ClampToBorder,
+      .mode_v         = SampleMode::ClampToBorder,
+      .mip_lod_bias   = 0.5f,
+      .enable_compare = true,
+      .compare_op     = CompareOp::Less,
+      .border_color   = BorderColor::FloatOpaqueWhite
+    });
+    CHECK( sampler.is_valid() );
+  }
+}
+
 TEST_CASE( "destroy sampler" ) {
   std::println(std::cout, "--- destroy sampler ---");
 
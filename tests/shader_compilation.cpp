@@ -2,6 +2,10 @@
 
 #include <catch2/catch_test_macros.hpp>
 
+#include "groot_shaders/precompiled_comp.hpp"
+
+#include <filesystem>
+#include <fstream>
 #include <iostream>
 
 using namespace groot;
@@ -27,6 +31,72 @@ TEST_CASE( "destroy shader" ) {
   CHECK_FALSE( shader.is_valid() );
 }
 
+TEST_CASE( "compile shader batch" ) {
+  std::println(std::cout, "--- compile shader batch ---");
+
+  Engine engine;
+
+  std::vector<ShaderDesc> descs = {
+    { ShaderType::Vertex, std::format("{}/dat/cube_vert.glsl", GROOT_TEST_DIR) },
+    { ShaderType::Fragment, std::format("{}/dat/cube_frag.glsl", GROOT_TEST_DIR) },
+    { ShaderType::Vertex, "" },
+    { ShaderType::Compute, std::format("{}/dat/post.comp", GROOT_TEST_DIR) },
+    { ShaderType::Vertex, std::format("{}/dat/cube_vert.glsl", GROOT_TEST_DIR) }
+  };
+
+  std::vector<RID> shaders = engine.compile_shaders(descs);
+  REQUIRE( shaders.size() == descs.size() );
+  CHECK( shaders[0].is_valid() );
+  CHECK( shaders[1].is_valid() );
+  CHECK_FALSE( shaders[2].is_valid() );
+  CHECK( shaders[3].is_valid() );
+  CHECK( shaders[4] == shaders[0] );
+}
+
+TEST_CASE( "shader caching" ) {
+  SECTION( "identical compiles share a module" ) {
+    std::println(std::cout, "--- deduplicate shaders ---");
+
+    Engine engine;
+
+    RID first = engine.compile_shader(ShaderType::Vertex, std::format("{}/dat/shader.glsl", GROOT_TEST_DIR));
+    RID second = engine.compile_shader(ShaderType::Vertex, std::format("{}/dat/shader.glsl", GROOT_TEST_DIR));
+    REQUIRE( first.is_valid() );
+    CHECK( first == second );
+
+    engine.destroy_shader(first);
+    CHECK_FALSE( first.is_valid() );
+    CHECK( second.is_valid() );
+
+    engine.destroy_shader(second);
+    CHECK_FALSE( second.is_valid() );
+  }
+
+  SECTION( "spir-v persists across engines" ) {
+    std::println(std::cout, "--- on-disk shader cache ---");
+
+    std::filesystem::path cache = std::filesystem::temp_directory_path() / "groot_shader_cache_test";
+    std::filesystem::remove_all(cache);
+
+    {
+      Engine engine(Settings{ .cache_directory = cache.string() });
+      RID shader = engine.compile_shader(ShaderType::Vertex, std::format("{}/dat/shader.glsl", GROOT_TEST_DIR));
+      REQUIRE( shader.is_valid() );
+    }
+
+    REQUIRE( std::filesystem::exists(cache) );
+    CHECK( std::distance(std::filesystem::directory_iterator(cache), std::filesystem::directory_iterator()) == 1 );
+
+    {
+      Engine engine(Settings{ .cache_directory = cache.string() });
+      RID shader = engine.compile_shader(ShaderType::Vertex, std::format("{}/dat/shader.glsl", GROOT_TEST_DIR));
+      CHECK( shader.is_valid() );
+    }
+
+    std::filesystem::remove_all(cache);
+  }
+}
+
 TEST_CASE( "invalid shader path" ) {
   std::println(std::cout, "--- invalid shader path ---");
 
@@ -34,4 +104,102 @@ TEST_CASE( "invalid shader path" ) {
 
   RID shader = engine.compile_shader(ShaderType::Vertex, "");
   CHECK_FALSE( shader.is_valid() );
-}
\ No newline at end of file
+}
+
+TEST_CASE( "shader hot reload" ) {
+  std::println(std::cout, "--- shader hot reload ---");
+
+  std::filesystem::path path = std::filesystem::temp_directory_path() / "groot_hot_reload_test.comp";
+  auto writeShader = [&path](int value) {
+    std::ofstream(path) << std::format(
+      "#version 450\n"
+      "layout(binding = 0) buffer test_buffer {{ int _Nums[]; }};\n"
+      "layout(local_size_x = 8, local_size_y = 1, local_size_z = 1) in;\n"
+      "void main() {{ _Nums[gl_GlobalInvocationID.x] = {}; }}\n",
+      value
+    );
+  };
+  writeShader(1);
+
+  Engine engine(Settings{ .hot_reload_shaders = true });
+
+  RID buffer = engine.create_storage_buffer(256 * sizeof(int));
+  RID set = engine.create_descriptor_set({ buffer });
+  RID shader = engine.compile_shader(ShaderType::Compute, path.string());
+  REQUIRE( shader.is_valid() );
+
+  RID pipeline = engine.create_compute_pipeline(shader, set);
+  REQUIRE( pipeline.is_valid() );
+
+  ComputeCommand cmd{
+    .pipeline       = pipeline,
+    .descriptor_set = set,
+    .work_groups    = { 32, 1, 1 }
+  };
+
+  bool rewritten = false;
+  double elapsed = 0.0;
+  engine.run([&](double dt){
+    engine.dispatch(cmd);
+
+    std::vector<int> nums = engine.read_buffer<int>(buffer);
+    if (!rewritten && nums == std::vector<int>(256, 1)) {
+      writeShader(2);
+      rewritten = true;
+    }
+
+    elapsed += dt;
+    if ((rewritten && nums == std::vector<int>(256, 2)) || elapsed > 10.0)
+      engine.close_window();
+  });
+
+  REQUIRE( rewritten );
+  CHECK( engine.read_buffer<int>(buffer) == std::vector<int>(256, 2) );
+
+  engine.destroy_shader(shader);
+  CHECK_FALSE( shader.is_valid() );
+
+  std::filesystem::remove(path);
+}
+
+TEST_CASE( "shader variants" ) {
+  std::println(std::cout, "--- shader variants ---");
+
+  Engine engine;
+  std::string path = std::format("{}/dat/variant.glsl", GROOT_TEST_DIR);
+
+  RID red = engine.compile_shader(ShaderType::Fragment, path, { { "RED" } });
+  RID grey = engine.compile_shader(ShaderType::Fragment, path, { { "SHADE", "0.5" } });
+  RID white = engine.compile_shader(ShaderType::Fragment, path, { { "SHADE", "1.0" } });
+  RID redAgain = engine.compile_shader(ShaderType::Fragment, path, { { "RED" } });
+  REQUIRE( red.is_valid() );
+  REQUIRE( grey.is_valid() );
+  REQUIRE( white.is_valid() );
+  CHECK( red != grey );
+  CHECK( grey != white );
+  CHECK( red == redAgain );
+
+  RID missing = engine.compile_shader(ShaderType::Fragment, path);
+  CHECK_FALSE( missing.is_valid() );
+}
+
+TEST_CASE( "precompiled shaders" ) {
+  std::println(std::cout, "--- load precompiled shaders ---");
+
+  Engine engine;
+
+  RID file = engine.load_shader_spirv(ShaderType::Compute, std::format("{}/precompiled.comp.spv", GROOT_SPIRV_DIR));
+  REQUIRE( file.is_valid() );
+
+  RID embedded = engine.load_shader_spirv(ShaderType::Compute, groot_shaders::precompiled_comp);
+  REQUIRE( embedded.is_valid() );
+  CHECK( file == embedded );
+
+  RID buffer = engine.create_storage_buffer(256 * sizeof(int));
+  RID set = engine.create_descriptor_set({ buffer });
+  RID pipeline = engine.create_compute_pipeline(embedded, set);
+  CHECK( pipeline.is_valid() );
+
+  RID glsl = engine.load_shader_spirv(ShaderType::Compute, std::format("{}/dat/shader.glsl", GROOT_TEST_DIR));
+  CHECK_FALSE( glsl.is_valid() );
+}